@@ -0,0 +1,162 @@
+/**
+ * @file inline_vector.h
+ * @brief 定容量内联存储的顺序容器
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace modbus
+{
+
+/**
+ * @brief 容量固定、元素内联存放的vector替代品
+ * @details 接口与 std::vector 常用部分一致，不进行任何堆分配；
+ *          超出容量时抛出 std::length_error
+ * @tparam T 元素类型，须为平凡可复制类型
+ * @tparam N 最大容量
+ */
+template <typename T, size_t N>
+class InlineVector
+{
+    static_assert(std::is_trivially_copyable<T>::value, "InlineVector requires trivially copyable elements");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    InlineVector() = default;
+
+    InlineVector(std::initializer_list<T> init)
+    {
+        assign(init.begin(), init.end());
+    }
+
+    template <typename InputIt,
+              typename = typename std::iterator_traits<InputIt>::iterator_category>
+    InlineVector(InputIt first, InputIt last)
+    {
+        assign(first, last);
+    }
+
+    /**
+     * @brief 由 std::vector 隐式构造，兼容原有以vector赋值的代码
+     */
+    InlineVector(const std::vector<T> &other)
+    {
+        assign(other.begin(), other.end());
+    }
+
+    InlineVector(const InlineVector &other)
+    {
+        assign(other.begin(), other.end());
+    }
+
+    InlineVector &operator=(const InlineVector &other)
+    {
+        if (this != &other)
+        {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    InlineVector &operator=(std::initializer_list<T> init)
+    {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    /**
+     * @brief 转换为 std::vector，兼容原有以vector接收数据的代码
+     */
+    operator std::vector<T>() const
+    {
+        return std::vector<T>(begin(), end());
+    }
+
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        size_type count = 0;
+        for (; first != last; ++first)
+        {
+            if (count == N)
+                throw std::length_error("InlineVector capacity exceeded");
+            data_[count++] = *first;
+        }
+        size_ = count;
+    }
+
+    void push_back(const T &value)
+    {
+        if (size_ == N)
+            throw std::length_error("InlineVector capacity exceeded");
+        data_[size_++] = value;
+    }
+
+    void pop_back() { --size_; }
+
+    void resize(size_type count, const T &value = T())
+    {
+        if (count > N)
+            throw std::length_error("InlineVector capacity exceeded");
+        if (count > size_)
+            std::fill(data_ + size_, data_ + count, value);
+        size_ = count;
+    }
+
+    void clear() { size_ = 0; }
+
+    size_type size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    static constexpr size_type capacity() { return N; }
+    static constexpr size_type max_size() { return N; }
+
+    T *data() { return data_; }
+    const T *data() const { return data_; }
+
+    T &operator[](size_type index) { return data_[index]; }
+    const T &operator[](size_type index) const { return data_[index]; }
+
+    T &front() { return data_[0]; }
+    const T &front() const { return data_[0]; }
+    T &back() { return data_[size_ - 1]; }
+    const T &back() const { return data_[size_ - 1]; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+    const_iterator cbegin() const { return data_; }
+    const_iterator cend() const { return data_ + size_; }
+
+    friend bool operator==(const InlineVector &lhs, const InlineVector &rhs)
+    {
+        return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator!=(const InlineVector &lhs, const InlineVector &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    size_type size_ = 0; ///< 当前元素个数
+    T data_[N];          ///< 内联存储，仅前size_个元素有效
+};
+
+} // namespace modbus
@@ -0,0 +1,161 @@
+/**
+ * @file modbus_awaitable.h
+ * @brief 基于asio完成令牌(completion token)的Modbus异步操作
+ * @details 在 SsModbusMaster 的回调式异步接口之上提供asio风格的异步操作，
+ *          完成处理器在其关联的执行器上运行，可与调用方的io_context集成：
+ *          - 传入回调：配合 asio::bind_executor 指定回调所在的执行器
+ *          - 传入 asio::use_future：返回std::future
+ *          - C++20下传入 asio::use_awaitable：在asio协程中 co_await，挂起期间不占用线程
+ *
+ *          协程示例：
+ *          @code
+ *          asio::awaitable<void> poll(SsModbusMaster &master)
+ *          {
+ *              auto values = co_await async_read_holding_registers(master, 1, 0, 10,
+ *                                                                  std::chrono::milliseconds(500),
+ *                                                                  asio::use_awaitable);
+ *              co_await async_write_single_register(master, 1, 100, values[0],
+ *                                                   std::chrono::milliseconds(500), asio::use_awaitable);
+ *          }
+ *          @endcode
+ * @note 本头文件依赖asio，使用方需自行加入asio的头文件路径；C++20协程需打开 MODBUS_ENABLE_COROUTINES
+ */
+
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <asio.hpp>
+
+#include "modbus_master.h"
+
+namespace modbus
+{
+
+namespace detail
+{
+
+/**
+ * @brief 异步操作的完成状态
+ * @details 持有完成处理器及其执行器上的工作计数，保证处理器执行前执行器不会因无任务而退出
+ */
+template <typename Handler>
+struct AsyncCompletion
+{
+    using Executor = asio::associated_executor_t<Handler>;
+
+    Handler handler;
+    asio::executor_work_guard<Executor> work;
+
+    explicit AsyncCompletion(Handler &&h)
+        : handler(std::move(h)), work(asio::get_associated_executor(handler))
+    {
+    }
+};
+
+/**
+ * @brief 把只可移动的完成处理器包装为可复制的回调
+ * @details 主站的回调在其内部线程上执行，这里把结果投递回处理器关联的执行器
+ */
+template <typename Handler>
+auto make_completion(Handler &&handler)
+{
+    auto state = std::make_shared<AsyncCompletion<std::decay_t<Handler>>>(std::forward<Handler>(handler));
+    return [state](auto... args) {
+        auto executor = state->work.get_executor();
+        asio::post(executor, [state, args...]() mutable {
+            state->handler(std::move(args)...);
+        });
+    };
+}
+
+} // namespace detail
+
+/**
+ * @brief 异步发送Modbus请求
+ * @param master 主站，生命周期须覆盖异步操作
+ * @param request 请求数据
+ * @param timeout 超时时间
+ * @param token 完成令牌，完成签名为 void(std::exception_ptr, ModbusResponse)
+ * @note 失败时exception_ptr非空，use_awaitable/use_future下表现为抛出与 send_request 相同的异常
+ */
+template <typename CompletionToken>
+auto async_send_request(SsModbusMaster &master, const ModbusRequest &request,
+                        std::chrono::milliseconds timeout, CompletionToken &&token)
+{
+    return asio::async_initiate<CompletionToken, void(std::exception_ptr, ModbusResponse)>(
+        [&master, request, timeout](auto handler) {
+            auto completion = detail::make_completion(std::move(handler));
+            master.send_request_async(request, timeout,
+                                      [completion](const ModbusResponse &response, std::exception_ptr error) {
+                completion(error, response);
+            });
+        },
+        token);
+}
+
+/**
+ * @brief 异步读取保持寄存器
+ * @param token 完成令牌，完成签名为 void(std::exception_ptr, std::vector<uint16_t>)
+ */
+template <typename CompletionToken>
+auto async_read_holding_registers(SsModbusMaster &master, uint8_t slave_address,
+                                  uint16_t start_address, uint16_t register_count,
+                                  std::chrono::milliseconds timeout, CompletionToken &&token)
+{
+    return asio::async_initiate<CompletionToken, void(std::exception_ptr, std::vector<uint16_t>)>(
+        [&master, slave_address, start_address, register_count, timeout](auto handler) {
+            auto completion = detail::make_completion(std::move(handler));
+            master.read_holding_registers_async(slave_address, start_address, register_count, timeout,
+                                                [completion](std::vector<uint16_t> values, std::exception_ptr error) {
+                completion(error, std::move(values));
+            });
+        },
+        token);
+}
+
+/**
+ * @brief 异步写入单个寄存器
+ * @param token 完成令牌，完成签名为 void(std::exception_ptr)
+ */
+template <typename CompletionToken>
+auto async_write_single_register(SsModbusMaster &master, uint8_t slave_address,
+                                 uint16_t address, uint16_t value,
+                                 std::chrono::milliseconds timeout, CompletionToken &&token)
+{
+    return asio::async_initiate<CompletionToken, void(std::exception_ptr)>(
+        [&master, slave_address, address, value, timeout](auto handler) {
+            auto completion = detail::make_completion(std::move(handler));
+            master.write_single_register_async(slave_address, address, value, timeout,
+                                               [completion](std::exception_ptr error) {
+                completion(error);
+            });
+        },
+        token);
+}
+
+/**
+ * @brief 异步写入多个寄存器
+ * @param token 完成令牌，完成签名为 void(std::exception_ptr)
+ */
+template <typename CompletionToken>
+auto async_write_multiple_registers(SsModbusMaster &master, uint8_t slave_address,
+                                    uint16_t start_address, const std::vector<uint16_t> &values,
+                                    std::chrono::milliseconds timeout, CompletionToken &&token)
+{
+    return asio::async_initiate<CompletionToken, void(std::exception_ptr)>(
+        [&master, slave_address, start_address, values, timeout](auto handler) {
+            auto completion = detail::make_completion(std::move(handler));
+            master.write_multiple_registers_async(slave_address, start_address, values, timeout,
+                                                  [completion](std::exception_ptr error) {
+                completion(error);
+            });
+        },
+        token);
+}
+
+} // namespace modbus
@@ -0,0 +1,138 @@
+/**
+ * @file modbus_crc.cpp
+ * @brief Modbus CRC16计算实现
+ */
+
+#include "modbus_crc.h"
+
+#include <atomic>
+
+namespace modbus
+{
+
+namespace
+{
+
+using crc_detail::CRC16_TABLES;
+
+using Crc16Function = uint16_t (*)(const uint8_t *, size_t);
+
+// 编译期选择的默认引擎
+#if defined(MODBUS_CRC_ENGINE_BITWISE)
+constexpr Crc16Engine DEFAULT_ENGINE = Crc16Engine::BITWISE;
+#elif defined(MODBUS_CRC_ENGINE_TABLE)
+constexpr Crc16Engine DEFAULT_ENGINE = Crc16Engine::TABLE;
+#elif defined(MODBUS_CRC_ENGINE_SLICE4)
+constexpr Crc16Engine DEFAULT_ENGINE = Crc16Engine::SLICE_BY_4;
+#else
+constexpr Crc16Engine DEFAULT_ENGINE = Crc16Engine::SLICE_BY_8;
+#endif
+
+constexpr Crc16Function engine_function(Crc16Engine engine)
+{
+    switch (engine)
+    {
+    case Crc16Engine::BITWISE:
+        return crc16_bitwise;
+    case Crc16Engine::TABLE:
+        return crc16_table;
+    case Crc16Engine::SLICE_BY_4:
+        return crc16_slice_by_4;
+    case Crc16Engine::SLICE_BY_8:
+    default:
+        return crc16_slice_by_8;
+    }
+}
+
+// 常量初始化，保证其他编译单元的静态初始化阶段也可安全使用
+std::atomic<Crc16Engine> g_engine{DEFAULT_ENGINE};
+std::atomic<Crc16Function> g_function{engine_function(DEFAULT_ENGINE)};
+
+// 处理不足一轮的尾部字节
+inline uint16_t crc16_table_tail(uint16_t crc, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        crc = (crc >> 8) ^ CRC16_TABLES[0][(crc ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+} // namespace
+
+uint16_t crc16_bitwise(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; ++i)
+    {
+        crc ^= data[i];
+        for (int j = 0; j < 8; ++j)
+        {
+            if (crc & 0x0001)
+                crc = (crc >> 1) ^ 0xA001;
+            else
+                crc >>= 1;
+        }
+    }
+    return crc;
+}
+
+uint16_t crc16_table(const uint8_t *data, size_t length)
+{
+    return crc16_table_tail(0xFFFF, data, length);
+}
+
+uint16_t crc16_slice_by_4(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    while (length >= 4)
+    {
+        // 前两字节并入CRC寄存器，后两字节直接查表
+        crc ^= data[0] | (data[1] << 8);
+        crc = CRC16_TABLES[3][crc & 0xFF] ^
+              CRC16_TABLES[2][crc >> 8] ^
+              CRC16_TABLES[1][data[2]] ^
+              CRC16_TABLES[0][data[3]];
+        data += 4;
+        length -= 4;
+    }
+    return crc16_table_tail(crc, data, length);
+}
+
+uint16_t crc16_slice_by_8(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    while (length >= 8)
+    {
+        crc ^= data[0] | (data[1] << 8);
+        crc = CRC16_TABLES[7][crc & 0xFF] ^
+              CRC16_TABLES[6][crc >> 8] ^
+              CRC16_TABLES[5][data[2]] ^
+              CRC16_TABLES[4][data[3]] ^
+              CRC16_TABLES[3][data[4]] ^
+              CRC16_TABLES[2][data[5]] ^
+              CRC16_TABLES[1][data[6]] ^
+              CRC16_TABLES[0][data[7]];
+        data += 8;
+        length -= 8;
+    }
+    return crc16_table_tail(crc, data, length);
+}
+
+uint16_t crc16(const uint8_t *data, size_t length)
+{
+    return g_function.load(std::memory_order_relaxed)(data, length);
+}
+
+void set_crc16_engine(Crc16Engine engine)
+{
+    g_function.store(engine_function(engine), std::memory_order_relaxed);
+    g_engine.store(engine, std::memory_order_relaxed);
+}
+
+Crc16Engine crc16_engine()
+{
+    return g_engine.load(std::memory_order_relaxed);
+}
+
+} // namespace modbus
@@ -0,0 +1,119 @@
+/**
+ * @file modbus_crc.h
+ * @brief Modbus CRC16计算实现
+ * @note 多项式0xA001(反射)，初值0xFFFF，各实现结果完全一致
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace modbus
+{
+
+/**
+ * @brief CRC16计算引擎
+ */
+enum class Crc16Engine : uint8_t
+{
+    BITWISE,    ///< 逐位计算，每字节8次迭代
+    TABLE,      ///< 256项查表，每字节1次查表
+    SLICE_BY_4, ///< 4表并行查表，每4字节一轮
+    SLICE_BY_8  ///< 8表并行查表，每8字节一轮
+};
+
+namespace crc_detail
+{
+
+using Crc16Table = std::array<std::array<uint16_t, 256>, 8>;
+
+/**
+ * @brief 生成slice-by-8查找表，第0张即为常规的256项查找表
+ */
+constexpr Crc16Table make_crc16_tables()
+{
+    Crc16Table tables{};
+    for (uint16_t n = 0; n < 256; ++n)
+    {
+        uint16_t crc = n;
+        for (int j = 0; j < 8; ++j)
+        {
+            crc = (crc & 0x0001) ? static_cast<uint16_t>((crc >> 1) ^ 0xA001) : static_cast<uint16_t>(crc >> 1);
+        }
+        tables[0][n] = crc;
+    }
+    for (size_t k = 1; k < tables.size(); ++k)
+    {
+        for (size_t n = 0; n < 256; ++n)
+        {
+            uint16_t prev = tables[k - 1][n];
+            tables[k][n] = static_cast<uint16_t>((prev >> 8) ^ tables[0][prev & 0xFF]);
+        }
+    }
+    return tables;
+}
+
+inline constexpr Crc16Table CRC16_TABLES = make_crc16_tables();
+
+} // namespace crc_detail
+
+/**
+ * @brief 可在常量表达式中使用的CRC16计算
+ * @param data 计算目标数据
+ * @param length 数据长度
+ * @return crc 的计算结果
+ * @note 运行期调用等价于查表引擎，热路径仍应使用 crc16()
+ */
+constexpr uint16_t crc16_constexpr(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; ++i)
+    {
+        crc = static_cast<uint16_t>((crc >> 8) ^ crc_detail::CRC16_TABLES[0][(crc ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+/**
+ * @brief 逐位计算CRC16
+ * @param data 计算目标数据
+ * @param length 数据长度
+ * @return crc 的计算结果
+ */
+uint16_t crc16_bitwise(const uint8_t *data, size_t length);
+
+/**
+ * @brief 查表计算CRC16
+ */
+uint16_t crc16_table(const uint8_t *data, size_t length);
+
+/**
+ * @brief slice-by-4计算CRC16
+ */
+uint16_t crc16_slice_by_4(const uint8_t *data, size_t length);
+
+/**
+ * @brief slice-by-8计算CRC16
+ */
+uint16_t crc16_slice_by_8(const uint8_t *data, size_t length);
+
+/**
+ * @brief 使用当前选择的引擎计算CRC16
+ */
+uint16_t crc16(const uint8_t *data, size_t length);
+
+/**
+ * @brief 运行时切换CRC16计算引擎
+ * @param engine 目标引擎
+ * @note 默认引擎由编译选项 MODBUS_CRC_ENGINE 决定，切换对所有线程立即生效
+ */
+void set_crc16_engine(Crc16Engine engine);
+
+/**
+ * @brief 获取当前CRC16计算引擎
+ */
+Crc16Engine crc16_engine();
+
+} // namespace modbus
@@ -0,0 +1,66 @@
+/**
+ * @file modbus_frame.h
+ * @brief 编译期构造Modbus请求帧
+ */
+
+#pragma once
+
+#include <array>
+#include <stdexcept>
+
+#include "modbus_crc.h"
+#include "modbus_types.h"
+
+namespace modbus
+{
+
+/**
+ * @brief 定长RTU请求帧：地址 + 功能码 + 地址(2) + 数量/值(2) + CRC(2)
+ */
+using FixedRequestFrame = std::array<uint8_t, 8>;
+
+/**
+ * @brief 构造定长请求帧(功能码03、04、06)
+ * @param slave_address 从站地址
+ * @param function_code 功能码
+ * @param address 起始地址/寄存器地址
+ * @param quantity 读取数量，写单个寄存器时为写入值
+ * @return 已附加CRC的完整请求帧
+ * @throw std::invalid_argument 功能码或数量非法(仅支持各传输层能解析其响应的功能码)；
+ *        在常量表达式中使用时表现为编译错误
+ * @note 固定轮询请求可在编译期生成，例如：
+ *       constexpr auto POLL = make_request_frame(3, FunctionCode::READ_HOLDING_REGISTERS, 0x1000, 40);
+ */
+constexpr FixedRequestFrame make_request_frame(uint8_t slave_address,
+                                               FunctionCode function_code,
+                                               uint16_t address,
+                                               uint16_t quantity)
+{
+    switch (function_code)
+    {
+    case FunctionCode::READ_HOLDING_REGISTERS:
+    case FunctionCode::READ_INPUT_REGISTERS:
+        if (quantity == 0 || quantity > 125)
+            throw std::invalid_argument("Register count must be 1-125");
+        break;
+    case FunctionCode::WRITE_SINGLE_REGISTER:
+        break;
+    default:
+        throw std::invalid_argument("Function code has no fixed-length request frame");
+    }
+
+    FixedRequestFrame frame{};
+    frame[0] = slave_address;
+    frame[1] = static_cast<uint8_t>(function_code);
+    frame[2] = static_cast<uint8_t>(address >> 8);
+    frame[3] = static_cast<uint8_t>(address & 0xFF);
+    frame[4] = static_cast<uint8_t>(quantity >> 8);
+    frame[5] = static_cast<uint8_t>(quantity & 0xFF);
+
+    uint16_t crc = crc16_constexpr(frame.data(), 6);
+    frame[6] = static_cast<uint8_t>(crc & 0xFF);
+    frame[7] = static_cast<uint8_t>(crc >> 8);
+    return frame;
+}
+
+} // namespace modbus
@@ -12,26 +12,65 @@
     using SerialPort = LinuxSerialPort;
 #endif
 
+#include <algorithm>
 #include <array>
 #include <mutex>
-#include <thread>
 #include <chrono>
+#include <stdexcept>
+#include <thread>
 
-using namespace std::chrono_literals;
+#include "modbus_poll/modbus_bus_runtime.h"
+#include "modbus_poll/modbus_bus_worker.h"
 
 namespace modbus
 {
 
+namespace
+{
+
+SerialConfig make_config(uint32_t baudrate, Parity parity, const Rs485Config &rs485)
+{
+    SerialConfig config;
+    config.baudrate = baudrate;
+    config.parity = parity;
+    config.rs485 = rs485;
+    return config;
+}
+
+} // namespace
+
 class ModbusRtuMaster::Impl
 {
 public:
-    Impl(const std::string &port, uint32_t baudrate, Parity parity)
-        : serialPort_(), baudrate_(baudrate), parity_(parity)
+    Impl(const std::string &port, const SerialConfig &config)
+        : serialPort_(), config_(config)
     {
-        if (!serialPort_.open(port, baudrate))
+        if (config_.baudrate == 0)
+        {
+            throw std::invalid_argument("Baudrate must not be zero");
+        }
+
+        if (!serialPort_.open(port, config_.baudrate, config_.data_bits, parity_char(config_.parity),
+                              config_.stop_bits))
         {
-            throw std::runtime_error("Failed to open serial port: " + port);
+            throw std::runtime_error("Failed to open serial port: " + port + ": " + serialPort_.lastError());
         }
+
+        const Rs485Config &rs485 = config_.rs485;
+        if (rs485.enabled &&
+            !serialPort_.setRs485(true, rs485.rts_on_send, rs485.delay_rts_before_send_us,
+                                  rs485.delay_rts_after_send_us, rs485.rx_during_tx))
+        {
+            std::string reason = serialPort_.lastError();
+            serialPort_.close();
+            throw std::runtime_error("Failed to configure RS-485 on " + port + ": " + reason);
+        }
+
+        // 字符时间按实际帧格式计算；波特率高于19200时t3.5固定为1.75ms
+        char_time_ = std::chrono::microseconds(
+            (static_cast<uint64_t>(config_.bits_per_char()) * 1000000 + config_.baudrate - 1) / config_.baudrate);
+        silent_interval_ = config_.baudrate > 19200 ? std::chrono::microseconds(1750)
+                                                    : (char_time_ * 7 + std::chrono::microseconds(1)) / 2;
     }
 
     ~Impl()
@@ -39,147 +78,363 @@ public:
         serialPort_.close();
     }
 
+    // 异步请求使用的工作线程：已在总线运行时登记的沿用其工作线程，否则按需创建私有线程
+    std::shared_ptr<ModbusBusWorker> async_worker(ModbusRtuMaster &owner)
+    {
+        auto shared = ModbusBusRuntime::instance().find(owner);
+        if (shared)
+            return shared;
+
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        if (!worker_)
+        {
+            // 不持有所有权，工作线程在主站析构时先于串口停止
+            worker_ = std::make_shared<ModbusBusWorker>(
+                std::shared_ptr<SsModbusMaster>(std::shared_ptr<void>(), &owner));
+        }
+        return worker_;
+    }
+
+    void stop_worker()
+    {
+        std::shared_ptr<ModbusBusWorker> worker;
+        {
+            std::lock_guard<std::mutex> lock(worker_mutex_);
+            worker.swap(worker_);
+        }
+    }
+
+    SerialLatency set_low_latency(uint32_t latency_timer_ms)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        serialPort_.setLowLatency(latency_timer_ms);
+        return latency();
+    }
+
+    SerialLatency serial_latency()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return latency();
+    }
+
+    const SerialConfig &serial_config() const { return config_; }
+
     ModbusResponse send_request(const ModbusRequest &request,
                                 std::chrono::milliseconds timeout)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        // 在栈上构建请求帧，发送路径不分配内存
+        SsModbusMaster::RequestFrameBuffer frame;
+        size_t size = SsModbusMaster::encode_request_frame(request, frame.data(), frame.size());
+
+        return send_frame(request, frame.data(), size, timeout);
+    }
 
-        // 构建请求帧
-        std::vector<uint8_t> frame = SsModbusMaster::build_request_frame(request);
+    ModbusResponse send_frame(const ModbusRequest &request,
+                              const uint8_t *frame, size_t size,
+                              std::chrono::milliseconds timeout)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
 
         // 清空接收缓冲区
         clear_input_buffer();
 
         // 发送请求
-        if (serialPort_.write(frame.data(), frame.size()) != frame.size())
-        {
-            throw std::runtime_error("Failed to send Modbus request");
-        }
+        transmit(frame, size);
 
         // 接收响应
         return receive_response(request, timeout);
     }
 
+    void send_requests(const ModbusRequest *requests, size_t count,
+                       std::chrono::milliseconds timeout,
+                       ModbusResponse *responses, std::exception_ptr *errors)
+    {
+        // 整批只占用一次总线，收到上一帧响应后立即发送下一帧
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool clean = false;
+        for (size_t i = 0; i < count; ++i)
+        {
+            errors[i] = nullptr;
+            try
+            {
+                SsModbusMaster::RequestFrameBuffer frame;
+                size_t size = SsModbusMaster::encode_request_frame(requests[i], frame.data(), frame.size());
+
+                // 上一个请求正常结束时输入缓冲区已为空，省去一次清空读取
+                if (!clean)
+                {
+                    clear_input_buffer();
+                }
+                clean = false;
+
+                transmit(frame.data(), size);
+                responses[i] = receive_response(requests[i], timeout);
+                clean = true;
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    }
+
 private:
     SerialPort serialPort_;
-    uint32_t baudrate_;
-    Parity parity_;
+    SerialConfig config_;
+    std::chrono::microseconds char_time_;       // 单个字符的传输时间
+    std::chrono::microseconds silent_interval_; // 帧间静默间隔t3.5
+    std::chrono::steady_clock::time_point bus_idle_at_; // 上一帧结束后总线可再次发送的时刻
     std::mutex mutex_;
+    std::mutex worker_mutex_;
+    std::shared_ptr<ModbusBusWorker> worker_;
+
+    static char parity_char(Parity parity)
+    {
+        switch (parity)
+        {
+        case Parity::EVEN:
+            return 'E';
+        case Parity::ODD:
+            return 'O';
+        default:
+            return 'N';
+        }
+    }
+
+    // 发送一帧：与上一帧之间至少间隔t3.5，否则总线上其他从站会把两帧识别为一帧
+    void transmit(const uint8_t *frame, size_t size)
+    {
+        if (std::chrono::steady_clock::now() < bus_idle_at_)
+        {
+            std::this_thread::sleep_until(bus_idle_at_);
+        }
+
+        if (serialPort_.write(frame, size) != size)
+        {
+            throw std::runtime_error("Failed to send Modbus request");
+        }
+    }
+
+    SerialLatency latency() const
+    {
+        SerialLatency result;
+        result.low_latency = serialPort_.lowLatency();
+        result.latency_timer_ms = serialPort_.latencyTimer();
+        return result;
+    }
 
     // 清空输入缓冲区
     void clear_input_buffer()
     {
-        uint8_t buffer[256];
+        uint8_t buffer[MAX_RTU_FRAME_SIZE];
         while (serialPort_.read(buffer, sizeof(buffer)) > 0)
         {
             // 持续读取直到缓冲区为空
         }
     }
 
-    // 接收响应
+    // 接收响应：以t3.5静默间隔划分帧，适用于任意功能码。
+    // 以本次请求的帧头开始但CRC错误的数据，能推算长度时立即报CRC错误，
+    // 否则无法与被拆开的帧区分，继续累积直到超时
     ModbusResponse receive_response(const ModbusRequest &request,
                                     std::chrono::milliseconds timeout)
     {
-        ModbusResponse response;
-        std::array<uint8_t, 256> buffer;
+        using Clock = std::chrono::steady_clock;
 
-        // 读取响应头 (地址+功能码)
-        if (!read_with_timeout(buffer.data(), 2, timeout))
-        {
-            throw std::runtime_error("Response timeout");
-        }
+        // 能由请求推算响应长度时，收齐且CRC正确即可返回，不必等满静默间隔；
+        // 下一帧发送前仍由transmit()保证t3.5间隔
+        size_t predicted = SsModbusMaster::get_expected_response_length(request);
 
-        response.slave_address = buffer[0];
-        response.function_code = static_cast<FunctionCode>(buffer[1]);
+        // 多留一个字节用于识别超长帧
+        std::array<uint8_t, MAX_RTU_FRAME_SIZE + 1> buffer;
+        size_t received = 0;
+        bool overflow = false; // 当前帧超长，按噪声丢弃直到下一个静默间隔
+        bool held = false;     // 当前帧在静默间隔处未收全，继续等待后续字节
+        Clock::time_point last;
+        auto deadline = Clock::now() + timeout;
 
-        // 检查异常响应
-        if (static_cast<uint8_t>(response.function_code) & 0x80)
+        while (true)
         {
-            if (!read_with_timeout(buffer.data(), 1, timeout))
+            auto now = Clock::now();
+            bool in_frame = received > 0 || overflow;
+            if (in_frame && !held && now >= last + silent_interval_)
             {
-                throw std::runtime_error("Incomplete exception response");
+                // 静默间隔到达，一帧结束；帧前夹杂的噪声字节在定位时跳过
+                if (!overflow)
+                {
+                    size_t start = locate_frame(request, buffer.data(), received);
+                    if (start < received)
+                    {
+                        return decode_response(request, buffer.data() + start, received - start);
+                    }
+
+                    if (is_addressed(request, buffer.data(), received))
+                    {
+                        // USB串口等按块提交数据时帧可能被拆开，不足应有长度的继续等待；
+                        // 无法推算长度的功能码一直累积到CRC正确或超时
+                        bool exception = buffer[1] & 0x80;
+                        if ((exception && received < 5) || (!exception && (predicted == 0 || received < predicted)))
+                        {
+                            held = true;
+                            continue;
+                        }
+                        throw std::runtime_error("CRC check failed");
+                    }
+                }
+
+                // 噪声或其他从站的帧：丢弃后立即开始识别下一帧
+                received = 0;
+                overflow = false;
+                continue;
             }
-            response.error = static_cast<ModbusError>(buffer[0]);
-            return response;
-        }
 
-        // 根据功能码处理正常响应
-        switch (response.function_code)
-        {
-        case FunctionCode::READ_HOLDING_REGISTERS:
-        case FunctionCode::READ_INPUT_REGISTERS:
-        {
-            if (!read_with_timeout(buffer.data(), 1, timeout))
+            if (now >= deadline)
             {
-                throw std::runtime_error("Incomplete read response");
+                if (!in_frame)
+                {
+                    throw std::runtime_error("Response timeout");
+                }
+                bool corrupted = predicted == 0 && !overflow && received >= 4 &&
+                                 is_addressed(request, buffer.data(), received);
+                throw std::runtime_error(corrupted ? "CRC check failed" : "Incomplete response");
             }
-            uint8_t byte_count = buffer[0];
-            if (!read_with_timeout(buffer.data() + 1, byte_count + 2, timeout))
+
+            // 帧内最多等待一个静默间隔，帧外等待到超时
+            auto until = in_frame && !held ? std::min(deadline, last + silent_interval_) : deadline;
+            auto wait = std::chrono::duration_cast<std::chrono::microseconds>(until - now);
+            size_t n = serialPort_.read(buffer.data() + received, buffer.size() - received, wait);
+            if (n == 0)
             {
-                throw std::runtime_error("Incomplete read data");
+                if (serialPort_.failed())
+                {
+                    throw std::runtime_error("Serial port error: " + serialPort_.lastError());
+                }
+                continue;
+            }
+
+            last = Clock::now();
+            bus_idle_at_ = last + silent_interval_;
+            held = false;
+            received += n;
+            if (received > MAX_RTU_FRAME_SIZE)
+            {
+                overflow = true;
+                received = 0;
+                continue;
+            }
+
+            if (!overflow && predicted > 0)
+            {
+                size_t start = complete_frame(request, buffer.data(), received, predicted);
+                if (start < received)
+                {
+                    return decode_response(request, buffer.data() + start, received - start);
+                }
             }
-            response.data.assign(buffer.begin() + 1, buffer.begin() + 1 + byte_count);
-            SsModbusMaster::verify_crc(buffer.data(), byte_count + 3);
-            break;
         }
-        case FunctionCode::WRITE_SINGLE_REGISTER:
+    }
+
+    // 帧头是否为本次请求的响应(含异常响应)
+    static bool is_addressed(const ModbusRequest &request, const uint8_t *frame, size_t size)
+    {
+        return size >= 2 && frame[0] == request.slave_address &&
+               (frame[1] & 0x7F) == static_cast<uint8_t>(request.function_code);
+    }
+
+    // 在一段以静默间隔结束的数据中查找本次请求的响应，返回起始位置，找不到返回size
+    static size_t locate_frame(const ModbusRequest &request, const uint8_t *data, size_t size)
+    {
+        for (size_t start = 0; start + 4 <= size; ++start)
         {
-            if (!read_with_timeout(buffer.data(), 6, timeout))
+            if (is_addressed(request, data + start, size - start) &&
+                SsModbusMaster::verify_crc(data + start, size - start))
             {
-                throw std::runtime_error("Incomplete write response");
+                return start;
             }
-            SsModbusMaster::verify_crc(buffer.data(), 6);
-            break;
         }
-        case FunctionCode::WRITE_MULTIPLE_REGISTERS:
+        return size;
+    }
+
+    // 检查已收到的数据末尾是否为一个推算长度的完整响应，返回起始位置，不是则返回size
+    static size_t complete_frame(const ModbusRequest &request, const uint8_t *data, size_t size,
+                                 size_t predicted)
+    {
+        for (size_t length : {predicted, static_cast<size_t>(5)})
         {
-            if (!read_with_timeout(buffer.data(), 6, timeout))
+            if (size < length)
+                continue;
+
+            size_t start = size - length;
+            bool exception = length == 5 && (data[start + 1] & 0x80);
+            if ((length == predicted || exception) && is_addressed(request, data + start, length) &&
+                SsModbusMaster::verify_crc(data + start, length))
             {
-                throw std::runtime_error("Incomplete write response");
+                return start;
             }
-            SsModbusMaster::verify_crc(buffer.data(), 6);
-            break;
         }
-        default:
-            throw std::runtime_error("Unsupported function code in response");
-        }
-
-        return response;
+        return size;
     }
 
-    // 带超时的读取
-    bool read_with_timeout(uint8_t *buffer, size_t length,
-                           std::chrono::milliseconds timeout)
+    // 解析一个CRC已校验的响应帧
+    static ModbusResponse decode_response(const ModbusRequest &request, const uint8_t *frame, size_t size)
     {
-        auto start = std::chrono::steady_clock::now();
-        size_t total_read = 0;
+        ModbusResponse response;
+        response.slave_address = frame[0];
+        response.function_code = static_cast<FunctionCode>(frame[1]);
+        response.error = ModbusError::NO_ERROR;
+
+        // 检查异常响应
+        if (frame[1] & 0x80)
+        {
+            if (size != 5)
+            {
+                throw std::runtime_error("Invalid response length");
+            }
+            response.error = static_cast<ModbusError>(frame[2]);
+            return response;
+        }
 
-        while (total_read < length)
+        switch (request.function_code)
         {
-            size_t n = serialPort_.read(buffer + total_read, length - total_read);
-            if (n > 0)
+        case FunctionCode::READ_HOLDING_REGISTERS:
+        case FunctionCode::READ_INPUT_REGISTERS:
+            if (size < 5 || frame[2] != size - 5)
             {
-                total_read += n;
+                throw std::runtime_error("Invalid response byte count");
             }
-            else
+            response.data.assign(frame + 3, frame + size - 2);
+            break;
+
+        case FunctionCode::WRITE_SINGLE_REGISTER:
+        case FunctionCode::WRITE_MULTIPLE_REGISTERS:
+            if (size != 8)
             {
-                if (std::chrono::steady_clock::now() - start > timeout)
-                {
-                    return false;
-                }
-                std::this_thread::sleep_for(10ms);
+                throw std::runtime_error("Invalid response length");
             }
+            break;
+
+        default:
+            // 其他功能码原样返回功能码之后的数据
+            response.data.assign(frame + 2, frame + size - 2);
+            break;
         }
 
-        return true;
+        return response;
     }
 };
 
 // ModbusRtuMaster包装实现
-ModbusRtuMaster::ModbusRtuMaster(const std::string &port, uint32_t baudrate, Parity parity)
-    : impl_(std::make_unique<Impl>(port, baudrate, parity)) {}
+ModbusRtuMaster::ModbusRtuMaster(const std::string &port, uint32_t baudrate, Parity parity,
+                                 const Rs485Config &rs485)
+    : impl_(std::make_unique<Impl>(port, make_config(baudrate, parity, rs485))) {}
+
+ModbusRtuMaster::ModbusRtuMaster(const std::string &port, const SerialConfig &config)
+    : impl_(std::make_unique<Impl>(port, config)) {}
 
-ModbusRtuMaster::~ModbusRtuMaster() = default;
+ModbusRtuMaster::~ModbusRtuMaster()
+{
+    impl_->stop_worker();
+}
 
 ModbusResponse ModbusRtuMaster::send_request(const ModbusRequest &request,
                                              std::chrono::milliseconds timeout)
@@ -187,4 +442,50 @@ ModbusResponse ModbusRtuMaster::send_request(const ModbusRequest &request,
     return impl_->send_request(request, timeout);
 }
 
+void ModbusRtuMaster::send_request_async(const ModbusRequest &request,
+                                         std::chrono::milliseconds timeout,
+                                         ResponseCallback callback)
+{
+    impl_->async_worker(*this)->submit(request, timeout, std::move(callback));
+}
+
+void ModbusRtuMaster::send_requests(const ModbusRequest *requests, size_t count,
+                                    std::chrono::milliseconds timeout,
+                                    ModbusResponse *responses, std::exception_ptr *errors)
+{
+    impl_->send_requests(requests, count, timeout, responses, errors);
+}
+
+SerialLatency ModbusRtuMaster::set_low_latency(uint32_t latency_timer_ms)
+{
+    return impl_->set_low_latency(latency_timer_ms);
+}
+
+SerialLatency ModbusRtuMaster::serial_latency() const
+{
+    return impl_->serial_latency();
+}
+
+const SerialConfig &ModbusRtuMaster::serial_config() const
+{
+    return impl_->serial_config();
+}
+
+uint32_t ModbusRtuMaster::baudrate() const
+{
+    return impl_->serial_config().baudrate;
+}
+
+Parity ModbusRtuMaster::parity() const
+{
+    return impl_->serial_config().parity;
+}
+
+ModbusResponse ModbusRtuMaster::send_encoded_request(const ModbusRequest &request,
+                                                     const uint8_t *frame, size_t size,
+                                                     std::chrono::milliseconds timeout)
+{
+    return impl_->send_frame(request, frame, size, timeout);
+}
+
 } // namespace modbus
\ No newline at end of file
@@ -15,12 +15,85 @@ namespace modbus
 class ModbusRtuMaster : public SsModbusMaster
 {
 public:
-    explicit ModbusRtuMaster(const std::string &port, uint32_t baudrate = 9600, Parity parity = Parity::NONE);
+    /**
+     * @brief 构造函数
+     * @param port 串口设备
+     * @param baudrate 波特率
+     * @param parity 校验方式
+     * @param rs485 RS-485方向控制配置，启用时由串口驱动切换收发方向
+     * @throw std::runtime_error 如果串口打开失败或驱动不支持所需的RS-485配置
+     */
+    explicit ModbusRtuMaster(const std::string &port, uint32_t baudrate = 9600, Parity parity = Parity::NONE,
+                             const Rs485Config &rs485 = Rs485Config());
+
+    /**
+     * @brief 构造函数
+     * @param port 串口设备
+     * @param config 串口配置，含数据位、校验、停止位与RS-485设置
+     * @throw std::invalid_argument 如果波特率为0
+     * @throw std::runtime_error 如果串口打开失败、驱动不支持所需的帧格式或RS-485配置
+     * @note 帧间静默间隔t3.5按实际帧格式的字符时间计算，发送时保证与上一帧至少间隔t3.5
+     */
+    ModbusRtuMaster(const std::string &port, const SerialConfig &config);
     ~ModbusRtuMaster() override;
 
     ModbusResponse send_request(const ModbusRequest &request,
                                 std::chrono::milliseconds timeout) override;
 
+    using SsModbusMaster::send_requests;
+
+    /**
+     * @brief 批量发送请求
+     * @note 整批在一次总线占用内逐个收发，上一帧响应收完即发送下一帧，不与其他线程的请求交错
+     */
+    void send_requests(const ModbusRequest *requests, size_t count,
+                       std::chrono::milliseconds timeout,
+                       ModbusResponse *responses, std::exception_ptr *errors) override;
+
+    using SsModbusMaster::send_request_async;
+
+    /**
+     * @brief 异步发送Modbus请求
+     * @note 串口收发是阻塞的，请求交给总线工作线程串行执行：主站已在 ModbusBusRuntime
+     *       中登记时与其他提交者共用同一队列，否则首次调用时创建私有工作线程。回调在工作线程上执行
+     */
+    void send_request_async(const ModbusRequest &request,
+                            std::chrono::milliseconds timeout,
+                            ResponseCallback callback) override;
+
+    /**
+     * @brief 获取串口配置
+     */
+    const SerialConfig &serial_config() const;
+
+    /**
+     * @brief 获取串口波特率
+     */
+    uint32_t baudrate() const;
+
+    /**
+     * @brief 获取串口校验方式
+     */
+    Parity parity() const;
+
+    /**
+     * @brief 启用串口低延迟接收
+     * @param latency_timer_ms USB串口芯片(FTDI等)的接收缓冲延时(毫秒)，0表示不修改
+     * @return 设置后实际生效的值，未能完全生效时仍正常返回，可据此检查配置
+     * @note USB串口默认最多缓冲16ms才提交数据，会掩盖接收路径上的其他优化
+     */
+    SerialLatency set_low_latency(uint32_t latency_timer_ms = 1);
+
+    /**
+     * @brief 获取实际生效的接收延迟设置(打开串口时读取，set_low_latency后更新)
+     */
+    SerialLatency serial_latency() const;
+
+protected:
+    ModbusResponse send_encoded_request(const ModbusRequest &request,
+                                        const uint8_t *frame, size_t size,
+                                        std::chrono::milliseconds timeout) override;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
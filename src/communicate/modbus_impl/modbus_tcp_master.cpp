@@ -0,0 +1,684 @@
+/**
+ * @file modbus_tcp_master.cpp
+ * @brief Modbus TCP(MBAP)主站实现
+ * @note 所有socket操作都在内部io线程上执行，调用线程只负责登记事务并等待结果；
+ *       异步请求在槽位已满时进入后备队列，由释放槽位的一方依次启动
+ */
+
+#include "modbus_tcp_master.h"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <asio.hpp>
+
+namespace modbus
+{
+
+namespace
+{
+
+constexpr size_t MBAP_HEADER_SIZE = 7;   // 事务ID(2) + 协议ID(2) + 长度(2) + 单元ID(1)
+
+} // namespace
+
+/**
+ * @brief ModbusTcpMaster的实现类
+ */
+class ModbusTcpMaster::Impl
+{
+public:
+    Impl(const std::string &ip, uint16_t port, size_t max_in_flight);
+    ~Impl();
+
+    ModbusResponse send_request(const ModbusRequest &request,
+                                std::chrono::milliseconds timeout);
+
+    ModbusResponse send_frame(const uint8_t *frame, size_t size,
+                              std::chrono::milliseconds timeout);
+
+    void send_request_async(const ModbusRequest &request,
+                            std::chrono::milliseconds timeout,
+                            SsModbusMaster::ResponseCallback callback);
+
+private:
+    /**
+     * @brief 在途事务
+     */
+    struct Transaction
+    {
+        uint16_t transaction_id;                                  // 事务ID
+        uint8_t unit_id;                                          // 请求的单元ID
+        uint8_t function_code;                                    // 请求的功能码
+        std::chrono::steady_clock::time_point deadline;           // 超时时刻
+        std::array<uint8_t, MBAP_HEADER_SIZE + MAX_PDU_SIZE> adu; // 完整的MBAP帧
+        size_t adu_size;                                          // MBAP帧长度
+        SsModbusMaster::ResponseCallback completion;              // 完成回调，恰好调用一次
+        std::unique_ptr<asio::steady_timer> timer;                // 异步事务的超时定时器，仅io线程访问
+    };
+
+    // 由RTU帧构建事务，事务ID在登记时填入
+    static std::shared_ptr<Transaction> make_transaction(const uint8_t *frame, size_t size,
+                                                         std::chrono::steady_clock::time_point deadline,
+                                                         SsModbusMaster::ResponseCallback completion);
+
+    // 事务是否仍在等待响应(未超时、未失败)
+    bool is_pending(const std::shared_ptr<Transaction> &txn);
+
+    // 以下函数须持有mutex_调用
+    void register_locked(const std::shared_ptr<Transaction> &txn);
+    void promote_locked();
+
+    // 以下函数只在io线程上调用
+    void start_transaction(const std::shared_ptr<Transaction> &txn);
+    void start_timer(const std::shared_ptr<Transaction> &txn, std::chrono::steady_clock::time_point deadline);
+    void expire(const std::shared_ptr<Transaction> &txn);
+    static void complete(const std::shared_ptr<Transaction> &txn, const ModbusResponse &response,
+                         std::exception_ptr error);
+    void do_connect();
+    void arm_connect_timer(std::chrono::steady_clock::time_point deadline);
+    void do_write();
+    void do_read_header();
+    void do_read_body(uint16_t transaction_id, uint8_t unit_id, size_t pdu_size);
+    void handle_error(const std::string &reason);
+
+    // 完成事务，释放在途槽位；expected非空时仅当事务ID仍对应该事务才取出
+    std::shared_ptr<Transaction> take_pending(uint16_t transaction_id, const Transaction *expected = nullptr);
+
+    // 解析响应PDU，并校验其与请求对应
+    static bool parse_response_pdu(const Transaction &txn, uint8_t unit_id, const uint8_t *pdu, size_t size,
+                                   ModbusResponse &response);
+
+    asio::io_context io_;
+    asio::executor_work_guard<asio::io_context::executor_type> work_;
+    asio::ip::tcp::socket socket_;
+    asio::ip::tcp::endpoint target_;
+    asio::steady_timer connect_timer_;
+    std::thread io_thread_;
+
+    // io线程私有状态
+    uint32_t generation_ = 0;   // 连接代数，用于丢弃旧连接上的回调
+    bool connected_ = false;
+    bool connecting_ = false;
+    bool writing_ = false;
+    std::deque<std::shared_ptr<Transaction>> write_queue_;
+    std::array<uint8_t, MBAP_HEADER_SIZE> header_buffer_;
+    std::array<uint8_t, MAX_PDU_SIZE> body_buffer_;
+
+    // 调用线程与io线程共享状态
+    std::mutex mutex_;
+    std::condition_variable slot_cv_;
+    const size_t max_in_flight_;
+    uint16_t next_transaction_id_ = 0;
+    bool stopped_ = false;
+    std::unordered_map<uint16_t, std::shared_ptr<Transaction>> pending_requests_;
+    std::deque<std::shared_ptr<Transaction>> backlog_;   // 等待槽位的异步事务
+};
+
+/**
+ * @brief 构造函数
+ * @param ip 目标设备IP
+ * @param port 目标设备端口
+ * @param max_in_flight 最大在途事务数
+ */
+ModbusTcpMaster::Impl::Impl(const std::string &ip, uint16_t port, size_t max_in_flight)
+    : work_(asio::make_work_guard(io_))
+    , socket_(io_)
+    , connect_timer_(io_)
+    , max_in_flight_(std::min<size_t>(std::max<size_t>(max_in_flight, 1), 0xFFFF))
+{
+    asio::error_code ec;
+    auto address = asio::ip::make_address(ip, ec);
+    if (ec)
+    {
+        throw std::invalid_argument("Invalid Modbus TCP address: " + ip);
+    }
+    target_ = asio::ip::tcp::endpoint(address, port);
+
+    io_thread_ = std::thread([this]() { io_.run(); });
+}
+
+/**
+ * @brief 析构函数
+ */
+ModbusTcpMaster::Impl::~Impl()
+{
+    // 关闭连接后所有异步操作以取消结束，io线程随之退出
+    asio::post(io_, [this]() {
+        std::deque<std::shared_ptr<Transaction>> backlog;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+            backlog.swap(backlog_);
+        }
+        handle_error("Master destroyed");
+
+        auto error = std::make_exception_ptr(std::runtime_error("Master destroyed"));
+        for (auto &txn : backlog)
+        {
+            complete(txn, ModbusResponse(), error);
+        }
+    });
+    work_.reset();
+    if (io_thread_.joinable())
+    {
+        io_thread_.join();
+    }
+}
+
+/**
+ * @brief 发送Modbus请求并等待响应
+ * @param request Modbus请求
+ * @param timeout 超时时间
+ * @return Modbus响应
+ */
+ModbusResponse ModbusTcpMaster::Impl::send_request(const ModbusRequest &request,
+                                                   std::chrono::milliseconds timeout)
+{
+    // 在栈上构建RTU帧
+    SsModbusMaster::RequestFrameBuffer frame;
+    size_t size = SsModbusMaster::encode_request_frame(request, frame.data(), frame.size());
+
+    return send_frame(frame.data(), size, timeout);
+}
+
+/**
+ * @brief 以MBAP封装已编码的RTU请求帧并等待响应
+ * @param frame 完整RTU请求帧
+ * @param size 帧长度
+ * @param timeout 超时时间
+ * @return Modbus响应
+ */
+ModbusResponse ModbusTcpMaster::Impl::send_frame(const uint8_t *frame, size_t size,
+                                                 std::chrono::milliseconds timeout)
+{
+    auto end_time = std::chrono::steady_clock::now() + timeout;
+
+    auto promise = std::make_shared<std::promise<ModbusResponse>>();
+    std::future<ModbusResponse> future = promise->get_future();
+    auto txn = make_transaction(frame, size, end_time, [promise](const ModbusResponse &response, std::exception_ptr error) {
+        if (error)
+        {
+            promise->set_exception(error);
+        }
+        else
+        {
+            promise->set_value(response);
+        }
+    });
+
+    // 等待空闲槽位并分配事务ID
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!slot_cv_.wait_until(lock, end_time, [this]() {
+                return pending_requests_.size() < max_in_flight_;
+            }))
+        {
+            throw std::runtime_error("Response timeout");
+        }
+        register_locked(txn);
+    }
+
+    asio::post(io_, [this, txn]() { start_transaction(txn); });
+
+    if (future.wait_until(end_time) != std::future_status::ready)
+    {
+        // 超时的事务直接作废，迟到的响应会因找不到事务ID被丢弃；
+        // 若io线程已先取走该事务，结果随即就绪
+        if (take_pending(txn->transaction_id, txn.get()))
+        {
+            throw std::runtime_error("Response timeout");
+        }
+    }
+
+    return future.get();
+}
+
+/**
+ * @brief 异步发送Modbus请求
+ * @param request Modbus请求
+ * @param timeout 超时时间，包含在后备队列中等待槽位的时间
+ * @param callback 完成回调，在io线程上调用
+ */
+void ModbusTcpMaster::Impl::send_request_async(const ModbusRequest &request,
+                                               std::chrono::milliseconds timeout,
+                                               SsModbusMaster::ResponseCallback callback)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    std::shared_ptr<Transaction> txn;
+    try
+    {
+        SsModbusMaster::RequestFrameBuffer frame;
+        size_t size = SsModbusMaster::encode_request_frame(request, frame.data(), frame.size());
+        txn = make_transaction(frame.data(), size, deadline, callback);
+    }
+    catch (...)
+    {
+        callback(ModbusResponse(), std::current_exception());
+        return;
+    }
+
+    // 在锁内投递，保证定时器先于槽位释放方投递的启动任务建立
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_)
+    {
+        asio::post(io_, [txn]() {
+            complete(txn, ModbusResponse(), std::make_exception_ptr(std::runtime_error("Master destroyed")));
+        });
+        return;
+    }
+
+    bool started = backlog_.empty() && pending_requests_.size() < max_in_flight_;
+    if (started)
+    {
+        register_locked(txn);
+    }
+    else
+    {
+        backlog_.push_back(txn);
+    }
+
+    asio::post(io_, [this, txn, deadline, started]() {
+        start_timer(txn, deadline);
+        if (started)
+        {
+            start_transaction(txn);
+        }
+    });
+}
+
+std::shared_ptr<ModbusTcpMaster::Impl::Transaction>
+ModbusTcpMaster::Impl::make_transaction(const uint8_t *frame, size_t size,
+                                        std::chrono::steady_clock::time_point deadline,
+                                        SsModbusMaster::ResponseCallback completion)
+{
+    if (size < 4 || size > MAX_RTU_FRAME_SIZE)
+    {
+        throw std::invalid_argument("Invalid Modbus request frame size");
+    }
+
+    // RTU帧去掉CRC后即为 单元ID + PDU
+    size_t unit_pdu_size = size - 2;
+
+    // MBAP头 + 单元ID + PDU
+    auto txn = std::make_shared<Transaction>();
+    txn->unit_id = frame[0];
+    txn->function_code = frame[1];
+    txn->deadline = deadline;
+    txn->adu[2] = 0x00;
+    txn->adu[3] = 0x00;
+    txn->adu[4] = unit_pdu_size >> 8;
+    txn->adu[5] = unit_pdu_size & 0xFF;
+    std::copy(frame, frame + unit_pdu_size, txn->adu.begin() + 6);
+    txn->adu_size = 6 + unit_pdu_size;
+    txn->completion = std::move(completion);
+    return txn;
+}
+
+void ModbusTcpMaster::Impl::register_locked(const std::shared_ptr<Transaction> &txn)
+{
+    uint16_t tid = next_transaction_id_++;
+    while (pending_requests_.count(tid) != 0)
+    {
+        tid = next_transaction_id_++;
+    }
+    txn->transaction_id = tid;
+    txn->adu[0] = tid >> 8;
+    txn->adu[1] = tid & 0xFF;
+    pending_requests_[tid] = txn;
+}
+
+void ModbusTcpMaster::Impl::promote_locked()
+{
+    while (!stopped_ && !backlog_.empty() && pending_requests_.size() < max_in_flight_)
+    {
+        auto txn = std::move(backlog_.front());
+        backlog_.pop_front();
+        register_locked(txn);
+        asio::post(io_, [this, txn]() { start_transaction(txn); });
+    }
+}
+
+void ModbusTcpMaster::Impl::start_timer(const std::shared_ptr<Transaction> &txn,
+                                        std::chrono::steady_clock::time_point deadline)
+{
+    txn->timer = std::make_unique<asio::steady_timer>(io_, deadline);
+    txn->timer->async_wait([this, weak = std::weak_ptr<Transaction>(txn)](asio::error_code ec) {
+        auto txn = weak.lock();
+        if (!ec && txn)
+        {
+            expire(txn);
+        }
+    });
+}
+
+void ModbusTcpMaster::Impl::expire(const std::shared_ptr<Transaction> &txn)
+{
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find(backlog_.begin(), backlog_.end(), txn);
+        if (it != backlog_.end())
+        {
+            backlog_.erase(it);
+            found = true;
+        }
+    }
+
+    // 已发出的事务直接作废，迟到的响应会因找不到事务ID被丢弃
+    if (found || take_pending(txn->transaction_id, txn.get()))
+    {
+        complete(txn, ModbusResponse(), std::make_exception_ptr(std::runtime_error("Response timeout")));
+    }
+}
+
+void ModbusTcpMaster::Impl::complete(const std::shared_ptr<Transaction> &txn, const ModbusResponse &response,
+                                     std::exception_ptr error)
+{
+    txn->timer.reset();
+    txn->completion(response, error);
+}
+
+bool ModbusTcpMaster::Impl::is_pending(const std::shared_ptr<Transaction> &txn)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_requests_.find(txn->transaction_id);
+    return it != pending_requests_.end() && it->second == txn;
+}
+
+void ModbusTcpMaster::Impl::start_transaction(const std::shared_ptr<Transaction> &txn)
+{
+    // 启动前已超时的事务不再发送，调用方已收到超时错误
+    if (!is_pending(txn))
+        return;
+
+    write_queue_.push_back(txn);
+
+    if (connected_)
+    {
+        do_write();
+    }
+    else if (connecting_)
+    {
+        arm_connect_timer(txn->deadline);
+    }
+    else
+    {
+        do_connect();
+    }
+}
+
+void ModbusTcpMaster::Impl::do_connect()
+{
+    connecting_ = true;
+    connect_timer_.expires_at(std::chrono::steady_clock::time_point::min());
+    for (auto &txn : write_queue_)
+    {
+        arm_connect_timer(txn->deadline);
+    }
+
+    socket_.async_connect(target_, [this, gen = generation_](asio::error_code ec) {
+        if (gen != generation_)
+            return;
+        connecting_ = false;
+        connect_timer_.cancel();
+        if (ec)
+        {
+            handle_error("Failed to connect: " + ec.message());
+            return;
+        }
+
+        asio::error_code ignored;
+        socket_.set_option(asio::ip::tcp::no_delay(true), ignored);
+        connected_ = true;
+        do_read_header();
+        do_write();
+    });
+}
+
+void ModbusTcpMaster::Impl::arm_connect_timer(std::chrono::steady_clock::time_point deadline)
+{
+    // 连接最多持续到等待它的事务中最晚的超时时刻，届时已无事务需要该连接
+    if (deadline <= connect_timer_.expiry())
+        return;
+
+    connect_timer_.expires_at(deadline);
+    connect_timer_.async_wait([this, gen = generation_](asio::error_code ec) {
+        // 已到期的等待无法被取消，期限延后时以定时器当前的期限为准
+        if (ec || gen != generation_ || !connecting_ ||
+            connect_timer_.expiry() > std::chrono::steady_clock::now())
+            return;
+        handle_error("Connect timeout");
+    });
+}
+
+void ModbusTcpMaster::Impl::do_write()
+{
+    if (writing_ || write_queue_.empty())
+        return;
+
+    // 将排队中的所有请求合并为一次写操作，批次由回调持有直至写完成；
+    // 排队期间已超时的事务跳过，避免已报告失败的写请求在重试之后才到达设备
+    std::vector<std::shared_ptr<Transaction>> batch;
+    batch.reserve(write_queue_.size());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &txn : write_queue_)
+        {
+            auto it = pending_requests_.find(txn->transaction_id);
+            if (it != pending_requests_.end() && it->second == txn)
+            {
+                batch.push_back(txn);
+            }
+        }
+    }
+    write_queue_.clear();
+    if (batch.empty())
+        return;
+
+    std::vector<asio::const_buffer> buffers;
+    buffers.reserve(batch.size());
+    for (auto &txn : batch)
+    {
+        buffers.emplace_back(asio::buffer(txn->adu.data(), txn->adu_size));
+    }
+
+    writing_ = true;
+    asio::async_write(socket_, buffers,
+                      [this, gen = generation_, batch = std::move(batch)](asio::error_code ec, size_t) {
+        if (gen != generation_)
+            return;
+        writing_ = false;
+        if (ec)
+        {
+            handle_error("Failed to send Modbus request: " + ec.message());
+            return;
+        }
+        do_write();
+    });
+}
+
+void ModbusTcpMaster::Impl::do_read_header()
+{
+    asio::async_read(socket_, asio::buffer(header_buffer_), [this, gen = generation_](asio::error_code ec, size_t) {
+        if (gen != generation_)
+            return;
+        if (ec)
+        {
+            handle_error("Connection lost: " + ec.message());
+            return;
+        }
+
+        uint16_t tid = (header_buffer_[0] << 8) | header_buffer_[1];
+        uint16_t protocol = (header_buffer_[2] << 8) | header_buffer_[3];
+        uint16_t length = (header_buffer_[4] << 8) | header_buffer_[5];
+
+        // 长度字段包含单元ID，PDU至少包含功能码
+        if (protocol != 0 || length < 2 || length - 1u > MAX_PDU_SIZE)
+        {
+            handle_error("Invalid MBAP header");
+            return;
+        }
+
+        do_read_body(tid, header_buffer_[6], length - 1);
+    });
+}
+
+void ModbusTcpMaster::Impl::do_read_body(uint16_t transaction_id, uint8_t unit_id, size_t pdu_size)
+{
+    asio::async_read(socket_, asio::buffer(body_buffer_.data(), pdu_size),
+                     [this, gen = generation_, transaction_id, unit_id](asio::error_code ec, size_t size) {
+        if (gen != generation_)
+            return;
+        if (ec)
+        {
+            handle_error("Connection lost: " + ec.message());
+            return;
+        }
+
+        auto txn = take_pending(transaction_id);
+        if (txn)
+        {
+            ModbusResponse response;
+            if (parse_response_pdu(*txn, unit_id, body_buffer_.data(), size, response))
+            {
+                complete(txn, response, nullptr);
+            }
+            else
+            {
+                complete(txn, ModbusResponse(), std::make_exception_ptr(
+                    std::runtime_error("Invalid Modbus response")));
+            }
+        }
+
+        do_read_header();
+    });
+}
+
+void ModbusTcpMaster::Impl::handle_error(const std::string &reason)
+{
+    asio::error_code ignored;
+    socket_.close(ignored);
+    ++generation_;
+    connected_ = false;
+    connecting_ = false;
+    writing_ = false;
+    write_queue_.clear();
+
+    // 连接上所有在途事务均已失效，后备队列中的事务在新连接上继续
+    std::unordered_map<uint16_t, std::shared_ptr<Transaction>> failed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        failed.swap(pending_requests_);
+        promote_locked();
+    }
+    slot_cv_.notify_all();
+
+    auto error = std::make_exception_ptr(std::runtime_error(reason));
+    for (auto &pair : failed)
+    {
+        complete(pair.second, ModbusResponse(), error);
+    }
+}
+
+std::shared_ptr<ModbusTcpMaster::Impl::Transaction>
+ModbusTcpMaster::Impl::take_pending(uint16_t transaction_id, const Transaction *expected)
+{
+    std::shared_ptr<Transaction> txn;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pending_requests_.find(transaction_id);
+        if (it == pending_requests_.end() || (expected && it->second.get() != expected))
+            return nullptr;
+        txn = std::move(it->second);
+        pending_requests_.erase(it);
+        promote_locked();
+    }
+    slot_cv_.notify_one();
+    return txn;
+}
+
+/**
+ * @brief 解析响应PDU
+ * @param txn 事务ID对应的请求
+ * @param unit_id 单元ID
+ * @param pdu PDU数据(功能码起始)
+ * @param size PDU长度
+ * @param response 输出的响应对象
+ * @return 处理结果：true成功，false失败(包括单元ID、功能码或回显字段与请求不符)
+ */
+bool ModbusTcpMaster::Impl::parse_response_pdu(const Transaction &txn, uint8_t unit_id, const uint8_t *pdu,
+                                               size_t size, ModbusResponse &response)
+{
+    // 网关复用或改写事务ID时，不能把别的请求的响应交给本事务
+    if (unit_id != txn.unit_id || (pdu[0] & 0x7F) != txn.function_code)
+        return false;
+
+    response.slave_address = unit_id;
+    response.function_code = static_cast<FunctionCode>(pdu[0]);
+    response.error = ModbusError::NO_ERROR;
+
+    // 处理异常响应
+    if (pdu[0] & 0x80)
+    {
+        if (size != 2)
+            return false;
+        response.error = static_cast<ModbusError>(pdu[1]);
+        return true;
+    }
+
+    switch (response.function_code)
+    {
+    case FunctionCode::READ_HOLDING_REGISTERS:
+    case FunctionCode::READ_INPUT_REGISTERS:
+        if (size < 2 || size != (size_t)(2 + pdu[1]))
+            return false;
+        response.data.assign(pdu + 2, pdu + size);
+        return true;
+
+    case FunctionCode::WRITE_SINGLE_REGISTER:
+    case FunctionCode::WRITE_MULTIPLE_REGISTERS:
+        // 响应回显请求中的地址及值/数量
+        return size == 5 && std::equal(pdu + 1, pdu + 5, txn.adu.begin() + MBAP_HEADER_SIZE + 1);
+
+    default:
+        return false;
+    }
+}
+
+// ModbusTcpMaster成员函数实现
+ModbusTcpMaster::ModbusTcpMaster(const std::string &ip, uint16_t port, size_t max_in_flight)
+    : impl_(std::make_unique<Impl>(ip, port, max_in_flight)) {}
+
+ModbusTcpMaster::~ModbusTcpMaster() = default;
+
+ModbusResponse ModbusTcpMaster::send_request(const ModbusRequest &request,
+                                             std::chrono::milliseconds timeout)
+{
+    return impl_->send_request(request, timeout);
+}
+
+void ModbusTcpMaster::send_request_async(const ModbusRequest &request,
+                                         std::chrono::milliseconds timeout,
+                                         ResponseCallback callback)
+{
+    impl_->send_request_async(request, timeout, std::move(callback));
+}
+
+ModbusResponse ModbusTcpMaster::send_encoded_request(const ModbusRequest &,
+                                                     const uint8_t *frame, size_t size,
+                                                     std::chrono::milliseconds timeout)
+{
+    return impl_->send_frame(frame, size, timeout);
+}
+
+} // namespace modbus
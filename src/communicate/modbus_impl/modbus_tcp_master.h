@@ -0,0 +1,65 @@
+/**
+ * @file modbus_tcp_master.h
+ * @brief Modbus TCP(MBAP)主站实现
+ */
+
+#pragma once
+
+#include <string>
+#include <memory>
+#include <chrono>
+#include "modbus_master.h"
+
+namespace modbus
+{
+
+/**
+ * @brief Modbus TCP主站
+ * @details 在一条持久连接上以MBAP事务ID区分请求，允许多个请求同时在途(流水线)。
+ *          连接在首个请求时建立，连接尝试最多持续到等待它的请求中最晚的超时时刻；
+ *          响应须与请求的单元ID、功能码(及写请求的回显字段)一致，否则按无效响应处理
+ */
+class ModbusTcpMaster : public SsModbusMaster
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param ip 目标设备IP地址
+     * @param port 目标设备端口号
+     * @param max_in_flight 同一连接上允许同时未完成的最大事务数(1-65535，超出时截断)
+     */
+    explicit ModbusTcpMaster(const std::string &ip, uint16_t port = 502, size_t max_in_flight = 16);
+    ~ModbusTcpMaster() override;
+
+    /**
+     * @brief 发送Modbus请求并等待响应
+     * @param request Modbus请求对象
+     * @param timeout 超时时间(毫秒)，包含等待空闲事务槽的时间
+     * @return Modbus响应对象
+     * @throw std::runtime_error 如果连接失败、连接断开或超时
+     * @note 线程安全，多个线程可同时调用，请求在同一连接上并发在途
+     */
+    ModbusResponse send_request(const ModbusRequest &request,
+                                std::chrono::milliseconds timeout) override;
+
+    using SsModbusMaster::send_request_async;
+
+    /**
+     * @brief 异步发送Modbus请求，不占用调用线程
+     * @note 在途事务已满时请求进入后备队列，超时时间包含排队时间；回调在内部io线程上执行
+     */
+    void send_request_async(const ModbusRequest &request,
+                            std::chrono::milliseconds timeout,
+                            ResponseCallback callback) override;
+
+protected:
+    ModbusResponse send_encoded_request(const ModbusRequest &request,
+                                        const uint8_t *frame, size_t size,
+                                        std::chrono::milliseconds timeout) override;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace modbus
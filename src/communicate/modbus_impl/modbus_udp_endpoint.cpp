@@ -0,0 +1,381 @@
+/**
+ * @file modbus_udp_endpoint.cpp
+ * @brief 多设备共享的Modbus UDP本地端点实现
+ */
+
+#include "modbus_udp_endpoint.h"
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <asio.hpp>
+
+#ifdef PLATFORM_LINUX
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+namespace modbus
+{
+
+namespace
+{
+
+constexpr size_t MAX_DATAGRAM_SIZE = 1500;  // 接收缓冲区大小(以太网MTU)
+constexpr size_t MAX_ADU_SIZE = 256;        // Modbus RTU帧最大长度
+
+// 直接对原生句柄发送：asio的socket对象不允许在io线程上有进行中的async_receive_from时
+// 被其他线程并发使用，而内核的socket调用本身是线程安全的。句柄在端点关闭前一直有效，
+// 端点由挂接其上的主站共同持有，不会在发送期间关闭
+bool send_datagram(asio::ip::udp::socket::native_handle_type handle, const asio::ip::udp::endpoint &remote,
+                   const uint8_t *data, size_t size)
+{
+    while (true)
+    {
+        auto sent = ::sendto(handle, reinterpret_cast<const char *>(data), static_cast<int>(size), 0,
+                             remote.data(), static_cast<int>(remote.size()));
+        if (sent >= 0)
+            return static_cast<size_t>(sent) == size;
+
+#ifdef PLATFORM_LINUX
+        // asio发起异步接收后socket处于非阻塞模式，发送缓冲区满时等待可写
+        if (errno == EINTR)
+            continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            struct pollfd pfd = {handle, POLLOUT, 0};
+            if (::poll(&pfd, 1, -1) > 0)
+                continue;
+        }
+#endif
+        return false;
+    }
+}
+
+} // namespace
+
+class ModbusUdpEndpoint::Peer
+{
+public:
+    Peer(const asio::ip::udp::endpoint &remote, ReceiveHandler handler)
+        : remote_(remote), handler_(std::move(handler)) {}
+
+    // 在io线程上执行该设备的回调或任务，已解除挂接时跳过
+    template <typename Task>
+    void run(Task &&task)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (attached_)
+        {
+            task();
+        }
+    }
+
+    // 标记为已解除挂接，等待正在执行的回调结束；在回调中调用时不等待自身
+    void close()
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        attached_ = false;
+    }
+
+    asio::ip::udp::endpoint remote_;  // 远端地址
+    ReceiveHandler handler_;          // 接收回调
+
+private:
+    std::recursive_mutex mutex_;      // 回调执行期间持有
+    bool attached_ = true;            // 是否仍挂接在端点上
+};
+
+/**
+ * @brief ModbusUdpEndpoint的实现类
+ */
+class ModbusUdpEndpoint::Impl
+{
+public:
+    Impl(uint16_t local_port, const std::string &local_ip);
+
+    void start(const std::shared_ptr<Impl> &self);
+    void shutdown();
+
+    std::shared_ptr<Peer> attach(const std::string &ip, uint16_t port, ReceiveHandler handler);
+    void detach(const std::shared_ptr<Peer> &peer);
+    bool send(const Peer &peer, const uint8_t *data, size_t size);
+    size_t send_batch(const Peer &peer, const uint8_t *const *datagrams, const size_t *sizes, size_t count);
+    void schedule(const std::shared_ptr<Peer> &peer, std::chrono::steady_clock::time_point when,
+                  std::function<void()> task);
+    uint16_t local_port() const;
+
+private:
+    void do_receive();
+
+    asio::io_context io_;
+    asio::ip::udp::socket socket_;
+    std::thread io_thread_;
+
+    // io线程私有的接收缓冲区
+    asio::ip::udp::endpoint sender_;
+    std::array<uint8_t, MAX_DATAGRAM_SIZE> buffer_;
+
+    std::mutex send_mutex_;               // 串行化发送
+    mutable std::shared_mutex peers_mutex_; // 保护设备表，回调执行期间不持有
+    std::map<asio::ip::udp::endpoint, std::shared_ptr<Peer>> peers_;
+};
+
+ModbusUdpEndpoint::Impl::Impl(uint16_t local_port, const std::string &local_ip)
+    : socket_(io_)
+{
+    asio::error_code ec;
+    auto address = asio::ip::make_address(local_ip, ec);
+    if (ec)
+    {
+        throw std::invalid_argument("Invalid local address: " + local_ip);
+    }
+
+    asio::ip::udp::endpoint local(address, local_port);
+    socket_.open(local.protocol(), ec);
+    if (!ec)
+    {
+        socket_.bind(local, ec);
+    }
+    if (ec)
+    {
+        throw std::runtime_error("Failed to bind UDP endpoint: " + ec.message());
+    }
+
+    // 大量设备同时应答时避免内核丢包，失败不影响功能
+    socket_.set_option(asio::socket_base::receive_buffer_size(1 << 20), ec);
+}
+
+void ModbusUdpEndpoint::Impl::start(const std::shared_ptr<Impl> &self)
+{
+    do_receive();
+
+    // io线程持有实现对象，端点在回调中被释放时由io线程退出后销毁
+    io_thread_ = std::thread([self]() { self->io_.run(); });
+}
+
+void ModbusUdpEndpoint::Impl::shutdown()
+{
+    // 未到期的定时任务直接放弃，不等待其到期
+    asio::post(io_, [this]() {
+        asio::error_code ignored;
+        socket_.close(ignored);
+        io_.stop();
+    });
+
+    // 在回调中释放端点时不能等待自身
+    if (std::this_thread::get_id() == io_thread_.get_id())
+    {
+        io_thread_.detach();
+    }
+    else if (io_thread_.joinable())
+    {
+        io_thread_.join();
+    }
+}
+
+std::shared_ptr<ModbusUdpEndpoint::Peer>
+ModbusUdpEndpoint::Impl::attach(const std::string &ip, uint16_t port, ReceiveHandler handler)
+{
+    asio::error_code ec;
+    auto address = asio::ip::make_address(ip, ec);
+    if (ec)
+    {
+        throw std::invalid_argument("Invalid Modbus UDP address: " + ip);
+    }
+
+    auto peer = std::make_shared<Peer>(asio::ip::udp::endpoint(address, port), std::move(handler));
+
+    std::unique_lock<std::shared_mutex> lock(peers_mutex_);
+    if (!peers_.emplace(peer->remote_, peer).second)
+    {
+        throw std::invalid_argument("Modbus UDP device already attached: " + ip + ":" + std::to_string(port));
+    }
+    return peer;
+}
+
+void ModbusUdpEndpoint::Impl::detach(const std::shared_ptr<Peer> &peer)
+{
+    if (!peer)
+        return;
+
+    {
+        std::unique_lock<std::shared_mutex> lock(peers_mutex_);
+        auto it = peers_.find(peer->remote_);
+        if (it != peers_.end() && it->second == peer)
+        {
+            peers_.erase(it);
+        }
+    }
+
+    // 返回时没有正在执行的回调
+    peer->close();
+}
+
+bool ModbusUdpEndpoint::Impl::send(const Peer &peer, const uint8_t *data, size_t size)
+{
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    return send_datagram(socket_.native_handle(), peer.remote_, data, size);
+}
+
+size_t ModbusUdpEndpoint::Impl::send_batch(const Peer &peer, const uint8_t *const *datagrams,
+                                           const size_t *sizes, size_t count)
+{
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    size_t sent = 0;
+
+#ifdef PLATFORM_LINUX
+    // 一次系统调用提交多个数据报；socket处于非阻塞模式时可能只提交一部分，余下的逐个发送
+    std::vector<iovec> iov(count);
+    std::vector<mmsghdr> messages(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        iov[i].iov_base = const_cast<uint8_t *>(datagrams[i]);
+        iov[i].iov_len = sizes[i];
+        std::memset(&messages[i], 0, sizeof(mmsghdr));
+        messages[i].msg_hdr.msg_name = const_cast<sockaddr *>(peer.remote_.data());
+        messages[i].msg_hdr.msg_namelen = static_cast<socklen_t>(peer.remote_.size());
+        messages[i].msg_hdr.msg_iov = &iov[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while (sent < count)
+    {
+        int n = ::sendmmsg(socket_.native_handle(), messages.data() + sent,
+                           static_cast<unsigned int>(count - sent), 0);
+        if (n <= 0)
+            break;
+        sent += static_cast<size_t>(n);
+    }
+#endif
+
+    for (; sent < count; ++sent)
+    {
+        if (!send_datagram(socket_.native_handle(), peer.remote_, datagrams[sent], sizes[sent]))
+            break;
+    }
+    return sent;
+}
+
+void ModbusUdpEndpoint::Impl::schedule(const std::shared_ptr<Peer> &peer, std::chrono::steady_clock::time_point when,
+                                       std::function<void()> task)
+{
+    auto timer = std::make_shared<asio::steady_timer>(io_, when);
+    std::weak_ptr<Peer> weak_peer = peer;
+    timer->async_wait([this, timer, weak_peer, task = std::move(task)](asio::error_code ec) {
+        if (ec == asio::error::operation_aborted)
+            return;
+
+        // 与接收回调一样不持设备表锁执行，detach返回后不再有该设备的任务在运行
+        auto peer = weak_peer.lock();
+        if (peer)
+        {
+            peer->run(task);
+        }
+    });
+}
+
+uint16_t ModbusUdpEndpoint::Impl::local_port() const
+{
+    asio::error_code ec;
+    return socket_.local_endpoint(ec).port();
+}
+
+void ModbusUdpEndpoint::Impl::do_receive()
+{
+    socket_.async_receive_from(asio::buffer(buffer_), sender_, [this](asio::error_code ec, size_t size) {
+        if (ec == asio::error::operation_aborted || !socket_.is_open())
+            return;
+
+        // 按源地址分发，未挂接的来源及超长数据报直接丢弃
+        if (!ec && size <= MAX_ADU_SIZE)
+        {
+            // 只在查找时持锁，回调中可以挂接/解除设备或释放主站
+            std::shared_ptr<Peer> peer;
+            {
+                std::shared_lock<std::shared_mutex> lock(peers_mutex_);
+                auto it = peers_.find(sender_);
+                if (it != peers_.end())
+                {
+                    peer = it->second;
+                }
+            }
+            if (peer)
+            {
+                peer->run([&]() { peer->handler_(buffer_.data(), size); });
+            }
+        }
+
+        do_receive();
+    });
+}
+
+// ModbusUdpEndpoint成员函数实现
+ModbusUdpEndpoint::ModbusUdpEndpoint(uint16_t local_port, const std::string &local_ip)
+    : impl_(std::make_shared<Impl>(local_port, local_ip))
+{
+    impl_->start(impl_);
+}
+
+ModbusUdpEndpoint::~ModbusUdpEndpoint()
+{
+    impl_->shutdown();
+}
+
+std::shared_ptr<ModbusUdpEndpoint> ModbusUdpEndpoint::shared_default()
+{
+    static std::mutex mutex;
+    static std::weak_ptr<ModbusUdpEndpoint> instance;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto endpoint = instance.lock();
+    if (!endpoint)
+    {
+        endpoint = std::make_shared<ModbusUdpEndpoint>();
+        instance = endpoint;
+    }
+    return endpoint;
+}
+
+std::shared_ptr<ModbusUdpEndpoint::Peer>
+ModbusUdpEndpoint::attach(const std::string &ip, uint16_t port, ReceiveHandler handler)
+{
+    return impl_->attach(ip, port, std::move(handler));
+}
+
+void ModbusUdpEndpoint::detach(const std::shared_ptr<Peer> &peer)
+{
+    impl_->detach(peer);
+}
+
+bool ModbusUdpEndpoint::send(const Peer &peer, const uint8_t *data, size_t size)
+{
+    return impl_->send(peer, data, size);
+}
+
+void ModbusUdpEndpoint::schedule(const std::shared_ptr<Peer> &peer, std::chrono::steady_clock::time_point when,
+                                 std::function<void()> task)
+{
+    impl_->schedule(peer, when, std::move(task));
+}
+
+size_t ModbusUdpEndpoint::send_batch(const Peer &peer, const uint8_t *const *datagrams,
+                                     const size_t *sizes, size_t count)
+{
+    return impl_->send_batch(peer, datagrams, sizes, count);
+}
+
+uint16_t ModbusUdpEndpoint::local_port() const
+{
+    return impl_->local_port();
+}
+
+} // namespace modbus
@@ -0,0 +1,113 @@
+/**
+ * @file modbus_udp_endpoint.h
+ * @brief 多设备共享的Modbus UDP本地端点
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace modbus
+{
+
+/**
+ * @brief 共享UDP端点
+ * @details 一个端点只占用一个本地socket和一个接收线程，多个 ModbusUdpMaster 挂接其上，
+ *          收到的数据报按源 IP:端口 分发给对应的主站
+ */
+class ModbusUdpEndpoint
+{
+public:
+    /**
+     * @brief 数据报接收回调
+     * @param data 数据报内容
+     * @param size 数据报长度
+     * @note 在端点的接收线程上调用，应尽快返回。回调中可以挂接/解除设备、释放主站或端点，
+     *       但不能调用同步请求接口：响应由本线程接收，同步等待会一直阻塞到超时
+     */
+    using ReceiveHandler = std::function<void(const uint8_t *data, size_t size)>;
+
+    /**
+     * @brief 已挂接的远端设备(不透明句柄)
+     */
+    class Peer;
+
+    /**
+     * @brief 构造函数
+     * @param local_port 本地端口，0表示由系统分配
+     * @param local_ip 本地绑定地址
+     * @throw std::runtime_error 如果socket创建或绑定失败
+     */
+    explicit ModbusUdpEndpoint(uint16_t local_port = 0, const std::string &local_ip = "0.0.0.0");
+    ~ModbusUdpEndpoint();
+
+    ModbusUdpEndpoint(const ModbusUdpEndpoint &) = delete;
+    ModbusUdpEndpoint &operator=(const ModbusUdpEndpoint &) = delete;
+
+    /**
+     * @brief 获取进程内默认共享端点
+     * @return 默认端点，最后一个使用者释放后自动关闭，再次获取时重新创建
+     */
+    static std::shared_ptr<ModbusUdpEndpoint> shared_default();
+
+    /**
+     * @brief 挂接远端设备
+     * @param ip 远端设备IP
+     * @param port 远端设备端口
+     * @param handler 来自该设备的数据报回调
+     * @return 远端设备句柄
+     * @throw std::invalid_argument 如果地址非法或该设备已被挂接
+     */
+    std::shared_ptr<Peer> attach(const std::string &ip, uint16_t port, ReceiveHandler handler);
+
+    /**
+     * @brief 解除挂接
+     * @param peer 远端设备句柄
+     * @note 返回后保证该设备的回调不再被调用；在该设备自身的回调中调用时立即返回
+     */
+    void detach(const std::shared_ptr<Peer> &peer);
+
+    /**
+     * @brief 向远端设备发送数据报
+     * @param peer 远端设备句柄
+     * @param data 数据指针
+     * @param size 数据长度
+     * @return 成功返回true，失败返回false
+     */
+    bool send(const Peer &peer, const uint8_t *data, size_t size);
+
+    /**
+     * @brief 向远端设备连续发送多个数据报
+     * @param peer 远端设备句柄
+     * @param datagrams 各数据报指针
+     * @param sizes 各数据报长度
+     * @param count 数据报数量
+     * @return 从首个开始连续发送成功的数据报数量
+     * @note Linux下以sendmmsg在一次系统调用中提交全部数据报
+     */
+    size_t send_batch(const Peer &peer, const uint8_t *const *datagrams, const size_t *sizes, size_t count);
+
+    /**
+     * @brief 在指定时刻于端点的接收线程上执行任务
+     * @param peer 任务所属的远端设备，解除挂接后其任务不再执行
+     * @param when 执行时刻
+     * @param task 任务，与接收回调串行执行
+     */
+    void schedule(const std::shared_ptr<Peer> &peer, std::chrono::steady_clock::time_point when,
+                  std::function<void()> task);
+
+    /**
+     * @brief 获取实际绑定的本地端口
+     */
+    uint16_t local_port() const;
+
+private:
+    class Impl;
+    std::shared_ptr<Impl> impl_; // 接收线程也持有，端点在回调中释放时由接收线程最后销毁
+};
+
+} // namespace modbus
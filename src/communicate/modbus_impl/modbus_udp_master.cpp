@@ -1,63 +1,99 @@
 /**
  * @file modbus_udp_master.cpp
  * @brief 简化版Modbus UDP主站实现
- * @note 采用轮询方式检查响应，避免锁竞争问题
+ * @note 每个在途请求持有自己的完成回调，收到响应时由接收回调直接完成请求，
+ *       同步请求的回调唤醒等待线程，异步请求的超时由端点定时任务处理；
+ *       响应先由共享端点按源地址分发，再按 (从站地址, 功能码, 回显字段) 与请求匹配，
+ *       允许多个请求并发在途；读响应不回显地址，匹配键相同的读请求依次发送，
+ *       前一个完成或超时后才发出下一个，已发出的读请求超时后再保留一个超时周期的占位，
+ *       期间到达的同键响应视为迟到响应丢弃
  */
 
 #include "modbus_udp_master.h"
 
-#include <atomic>
+#include <algorithm>
 #include <chrono>
-#include <condition_variable>
+#include <deque>
 #include <future>
+#include <map>
 #include <mutex>
-#include <queue>
-#include <thread>
-#include <unordered_map>
+#include <tuple>
+#include <vector>
 
-#include "udp-tcp-communicate/communicate_api.h"
+#include "modbus_udp_endpoint.h"
 
 namespace modbus
 {
 
+namespace
+{
+
+// 以promise完成请求的回调，供同步等待使用
+SsModbusMaster::ResponseCallback fulfil(std::shared_ptr<std::promise<ModbusResponse>> promise)
+{
+    return [promise](const ModbusResponse &response, std::exception_ptr error) {
+        if (error)
+        {
+            promise->set_exception(error);
+        }
+        else
+        {
+            promise->set_value(response);
+        }
+    };
+}
+
+} // namespace
+
 /**
  * @brief ModbusUdpMaster的实现类
- * @details 采用轮询方式检查响应，完全避免锁竞争
+ * @details 等待线程阻塞在各自请求的future上，空闲时不占用CPU
  */
 class ModbusUdpMaster::Impl
 {
 public:
-    Impl(const std::string &ip, uint16_t port);
+    Impl(std::shared_ptr<ModbusUdpEndpoint> endpoint, const std::string &ip, uint16_t port);
     ~Impl();
 
     ModbusResponse send_request(const ModbusRequest &request,
                                 std::chrono::milliseconds timeout);
 
+    ModbusResponse send_frame(const ModbusRequest &request,
+                              const uint8_t *frame, size_t size,
+                              std::chrono::milliseconds timeout);
+
+    void send_request_async(const ModbusRequest &request,
+                            std::chrono::milliseconds timeout,
+                            SsModbusMaster::ResponseCallback callback);
+
+    void send_requests(const ModbusRequest *requests, size_t count,
+                       std::chrono::milliseconds timeout,
+                       ModbusResponse *responses, std::exception_ptr *errors);
+
 private:
     /**
-     * @brief 响应消息处理器
+     * @brief 请求/响应匹配键
+     * @details 读请求以字节数区分，写请求以回显的地址和值(数量)区分
      */
-    class ResponseHandler : public communicate::SubscribebBase
+    struct MatchKey
     {
-    public:
-        explicit ResponseHandler(Impl *owner) : owner_(owner) {}
+        uint8_t slave_address;  // 从站地址
+        uint8_t function_code;  // 功能码(不含异常标志位)
+        uint16_t address;       // 回显地址
+        uint16_t quantity;      // 回显值/数量/字节数
 
-        int handleMsg(std::shared_ptr<void> msg) override
+        bool operator<(const MatchKey &other) const
         {
-            return owner_ ? owner_->handle_response(msg) : -1;
+            return std::tie(slave_address, function_code, address, quantity) <
+                   std::tie(other.slave_address, other.function_code, other.address, other.quantity);
         }
 
-    private:
-        Impl *owner_;
-    };
-
-    /**
-     * @brief 响应消息结构
-     */
-    struct ResponseMessage
-    {
-        std::vector<uint8_t> data;
-        std::chrono::steady_clock::time_point receive_time;
+        // 键是否不能区分请求(读请求不含地址)，此类请求同一时刻只能有一个在途
+        bool ambiguous() const
+        {
+            return function_code == static_cast<uint8_t>(FunctionCode::READ_HOLDING_REGISTERS) ||
+                   function_code == static_cast<uint8_t>(FunctionCode::READ_INPUT_REGISTERS);
+        }
     };
 
     /**
@@ -65,54 +101,92 @@ private:
      */
     struct RequestContext
     {
-        uint16_t transaction_id;                         // 事务ID
+        uint64_t sequence;                               // 发送序号
+        MatchKey key;                                    // 匹配键
         std::chrono::steady_clock::time_point send_time; // 发送时间
         std::chrono::milliseconds timeout;               // 超时时间
-        ModbusResponse response;                         // 响应数据
-        bool response_received = false;                  // 是否收到响应
-        bool processed = false;                          // 是否已处理
+        SsModbusMaster::ResponseCallback completion;     // 完成回调，恰好调用一次
+        bool started = false;                            // 是否已允许发送
+        bool expired = false;                            // 已超时，仅作为迟到响应的占位
+        SsModbusMaster::RequestFrameBuffer frame;        // 暂缓发送的请求帧
+        size_t frame_size = 0;                           // 暂缓发送的帧长度
     };
 
+    using PendingMap = std::map<MatchKey, std::deque<std::shared_ptr<RequestContext>>>;
+
+    // 登记请求，尚未发送；同键读请求在途时暂缓，send_now为false
+    std::shared_ptr<RequestContext> register_request(const ModbusRequest &request,
+                                                     const uint8_t *frame, size_t size,
+                                                     std::chrono::milliseconds timeout,
+                                                     SsModbusMaster::ResponseCallback completion,
+                                                     bool &send_now);
+
+    // 从队列中移除请求(调用方持锁)，返回因此可以发送的下一个请求
+    std::shared_ptr<RequestContext> erase_locked(PendingMap::iterator slot,
+                                                 std::deque<std::shared_ptr<RequestContext>>::iterator it);
+
+    // 发送此前暂缓的请求，发送失败时以异常结束该请求并继续发送下一个
+    void send_held(std::shared_ptr<RequestContext> context);
+
+    // 登记请求并发送，发送失败时抛出异常
+    std::shared_ptr<RequestContext> start_request(const ModbusRequest &request,
+                                                  const uint8_t *frame, size_t size,
+                                                  std::chrono::milliseconds timeout,
+                                                  SsModbusMaster::ResponseCallback completion);
+
+    // 阻塞等待请求完成，到期未完成时注销请求并抛出超时异常
+    ModbusResponse wait_response(const std::shared_ptr<RequestContext> &context,
+                                 std::future<ModbusResponse> &future);
+
+    // 由请求生成匹配键
+    static MatchKey make_request_key(const ModbusRequest &request);
+
+    // 由响应帧生成匹配键
+    static MatchKey make_response_key(const uint8_t *data, size_t size);
+
+    // 取出与响应匹配的最早请求
+    std::shared_ptr<RequestContext> take_matching(const uint8_t *data, size_t size,
+                                                  std::shared_ptr<RequestContext> &next);
+
+    // 从待处理表中移除请求，返回是否仍在表中；sent表示请求可能已到达设备
+    bool remove_pending(const std::shared_ptr<RequestContext> &context, bool sent);
+
     // 响应处理函数
-    int handle_response(std::shared_ptr<void> msg);
+    int handle_response(const uint8_t *data, size_t size);
 
     // 处理接收到的响应数据
     bool process_response_data(const uint8_t *data, size_t size, ModbusResponse &response);
 
-    std::string targetIp_;                     // 目标设备IP
-    uint16_t targetPort_;                      // 目标设备端口
-    std::unique_ptr<ResponseHandler> handler_; // 响应处理器
+    std::shared_ptr<ModbusUdpEndpoint> endpoint_;     // 共享本地端点
+    std::shared_ptr<ModbusUdpEndpoint::Peer> peer_;   // 目标设备在端点上的句柄
 
     // 线程同步
-    std::mutex mutex_;                 // 保护共享数据的互斥锁
-    std::atomic<bool> running_{false}; // 运行标志
-
-    std::atomic<uint16_t> transaction_id_{0}; // 事务ID计数器
+    std::mutex mutex_; // 保护共享数据的互斥锁
 
-    // 响应消息队列
-    std::queue<ResponseMessage> response_queue_;
+    uint64_t sequence_ = 0; // 发送序号计数器
 
-    // 待处理的请求映射表：事务ID -> 请求上下文
-    std::unordered_map<uint16_t, std::shared_ptr<RequestContext>> pending_requests_;
+    // 待处理的请求：匹配键 -> 按发送顺序排列的请求
+    PendingMap pending_requests_;
 };
 
 /**
  * @brief 构造函数
+ * @param endpoint 共享本地端点
  * @param ip 目标设备IP
  * @param port 目标设备端口
  */
-ModbusUdpMaster::Impl::Impl(const std::string &ip, uint16_t port)
-    : targetIp_(ip)
-    , targetPort_(port)
-    , handler_(std::make_unique<ResponseHandler>(this))
+ModbusUdpMaster::Impl::Impl(std::shared_ptr<ModbusUdpEndpoint> endpoint, const std::string &ip, uint16_t port)
+    : endpoint_(std::move(endpoint))
 {
-    // 订阅响应消息
-    if (::communicate::SubscribeLocal("", port, handler_.get()) != 0)
+    if (!endpoint_)
     {
-        throw std::runtime_error("Failed to subscribe response messages");
+        throw std::invalid_argument("Modbus UDP endpoint is null");
     }
 
-    running_ = true;
+    // 在共享端点上挂接目标设备，接收来自该设备的响应
+    peer_ = endpoint_->attach(ip, port, [this](const uint8_t *data, size_t size) {
+        handle_response(data, size);
+    });
 }
 
 /**
@@ -120,14 +194,22 @@ ModbusUdpMaster::Impl::Impl(const std::string &ip, uint16_t port)
  */
 ModbusUdpMaster::Impl::~Impl()
 {
-    running_ = false;
+    endpoint_->detach(peer_);
 
-    // 清理所有未完成请求
-    std::lock_guard<std::mutex> lock(mutex_);
-    pending_requests_.clear();
-    while (!response_queue_.empty())
+    // 所有未完成请求以异常结束
+    PendingMap abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        abandoned.swap(pending_requests_);
+    }
+    auto error = std::make_exception_ptr(std::runtime_error("Master destroyed"));
+    for (auto &slot : abandoned)
     {
-        response_queue_.pop();
+        for (auto &context : slot.second)
+        {
+            if (!context->expired)
+                context->completion(ModbusResponse(), error);
+        }
     }
 }
 
@@ -140,121 +222,488 @@ ModbusUdpMaster::Impl::~Impl()
 ModbusResponse ModbusUdpMaster::Impl::send_request(const ModbusRequest &request,
                                                    std::chrono::milliseconds timeout)
 {
-    // 生成唯一的事务ID
-    uint16_t tid = transaction_id_.fetch_add(1);
+    // 在栈上构建请求帧，发送路径不分配内存
+    SsModbusMaster::RequestFrameBuffer frame;
+    size_t size = SsModbusMaster::encode_request_frame(request, frame.data(), frame.size());
+
+    return send_frame(request, frame.data(), size, timeout);
+}
+
+/**
+ * @brief 发送已编码的请求帧并等待响应
+ * @param request 与帧内容一致的Modbus请求
+ * @param frame 完整请求帧
+ * @param size 帧长度
+ * @param timeout 超时时间
+ * @return Modbus响应
+ */
+ModbusResponse ModbusUdpMaster::Impl::send_frame(const ModbusRequest &request,
+                                                 const uint8_t *frame, size_t size,
+                                                 std::chrono::milliseconds timeout)
+{
+    auto promise = std::make_shared<std::promise<ModbusResponse>>();
+    std::future<ModbusResponse> future = promise->get_future();
+    auto context = start_request(request, frame, size, timeout, fulfil(promise));
+
+    return wait_response(context, future);
+}
+
+/**
+ * @brief 批量发送请求
+ * @details 先登记全部请求，再一次性发出所有数据报，然后统一等待响应，
+ *          整批耗时约为一次往返加上各帧的传输时间
+ * @param requests 请求数组
+ * @param count 请求数量
+ * @param timeout 每个请求的超时时间
+ * @param responses 输出响应数组
+ * @param errors 输出各请求的异常
+ */
+void ModbusUdpMaster::Impl::send_requests(const ModbusRequest *requests, size_t count,
+                                          std::chrono::milliseconds timeout,
+                                          ModbusResponse *responses, std::exception_ptr *errors)
+{
+    std::vector<SsModbusMaster::RequestFrameBuffer> frames(count);
+    std::vector<const uint8_t *> datagrams;
+    std::vector<size_t> sizes;
+    std::vector<size_t> indices;
+    std::vector<std::shared_ptr<RequestContext>> contexts(count);
+    std::vector<std::future<ModbusResponse>> futures(count);
+    datagrams.reserve(count);
+    sizes.reserve(count);
+    indices.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        errors[i] = nullptr;
+        try
+        {
+            size_t size = SsModbusMaster::encode_request_frame(requests[i], frames[i].data(), frames[i].size());
+            auto promise = std::make_shared<std::promise<ModbusResponse>>();
+            futures[i] = promise->get_future();
+            bool send_now = false;
+            contexts[i] = register_request(requests[i], frames[i].data(), size, timeout, fulfil(promise), send_now);
+            if (!send_now)
+                continue;
+
+            datagrams.push_back(frames[i].data());
+            sizes.push_back(size);
+            indices.push_back(i);
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+    }
+
+    // 超时从整批发出时开始计算，暂缓的请求也以此为起点
+    size_t sent = endpoint_->send_batch(*peer_, datagrams.data(), sizes.data(), datagrams.size());
+    auto send_time = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (contexts[i])
+            contexts[i]->send_time = send_time;
+    }
+    for (size_t j = 0; j < indices.size(); ++j)
+    {
+        size_t i = indices[j];
+        if (j >= sent)
+        {
+            remove_pending(contexts[i], false);
+            errors[i] = std::make_exception_ptr(std::runtime_error("Failed to send Modbus request"));
+            contexts[i].reset();
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!contexts[i])
+            continue;
+        try
+        {
+            responses[i] = wait_response(contexts[i], futures[i]);
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+    }
+}
+
+/**
+ * @brief 阻塞等待请求完成
+ * @param context 请求上下文
+ * @param future 请求结果
+ * @return Modbus响应
+ * @throw std::runtime_error 如果超时或请求失败
+ */
+ModbusResponse ModbusUdpMaster::Impl::wait_response(const std::shared_ptr<RequestContext> &context,
+                                                    std::future<ModbusResponse> &future)
+{
+    if (future.wait_until(context->send_time + context->timeout) != std::future_status::ready)
+    {
+        // 若回调已取走该请求，响应随即就绪
+        if (remove_pending(context, true))
+        {
+            throw std::runtime_error("Response timeout");
+        }
+    }
 
-    // 创建请求上下文
+    return future.get();
+}
+
+/**
+ * @brief 异步发送Modbus请求
+ * @param request Modbus请求
+ * @param timeout 超时时间
+ * @param callback 完成回调，在端点的接收线程上调用
+ */
+void ModbusUdpMaster::Impl::send_request_async(const ModbusRequest &request,
+                                               std::chrono::milliseconds timeout,
+                                               SsModbusMaster::ResponseCallback callback)
+{
+    std::shared_ptr<RequestContext> context;
+    try
+    {
+        SsModbusMaster::RequestFrameBuffer frame;
+        size_t size = SsModbusMaster::encode_request_frame(request, frame.data(), frame.size());
+        context = start_request(request, frame.data(), size, timeout, callback);
+    }
+    catch (...)
+    {
+        callback(ModbusResponse(), std::current_exception());
+        return;
+    }
+
+    // 到期仍未收到响应则以超时结束；与接收回调竞争时只有一方能从待处理表取走请求
+    std::weak_ptr<RequestContext> weak = context;
+    endpoint_->schedule(peer_, context->send_time + timeout, [this, weak]() {
+        auto context = weak.lock();
+        if (context && remove_pending(context, true))
+        {
+            context->completion(ModbusResponse(),
+                                std::make_exception_ptr(std::runtime_error("Response timeout")));
+        }
+    });
+}
+
+/**
+ * @brief 登记请求
+ * @details 读响应只能以字节数匹配，若同键读请求并发在途，前一个丢失时后一个的响应
+ *          会被交给前一个请求，调用方拿到其他地址的数据；因此同键读请求在途时
+ *          新请求暂缓发送(保存帧副本)，待前一个完成或超时后再发出，超时时间包含等待时间
+ * @param request Modbus请求
+ * @param frame 完整请求帧
+ * @param size 帧长度
+ * @param timeout 超时时间
+ * @param completion 完成回调
+ * @param send_now 输出是否应立即发送，false表示暂缓，由前一个请求结束时发出
+ * @return 请求上下文
+ */
+std::shared_ptr<ModbusUdpMaster::Impl::RequestContext>
+ModbusUdpMaster::Impl::register_request(const ModbusRequest &request,
+                                        const uint8_t *frame, size_t size,
+                                        std::chrono::milliseconds timeout,
+                                        SsModbusMaster::ResponseCallback completion,
+                                        bool &send_now)
+{
     auto context = std::make_shared<RequestContext>();
-    context->transaction_id = tid;
+    context->key = make_request_key(request);
     context->send_time = std::chrono::steady_clock::now();
     context->timeout = timeout;
+    context->completion = std::move(completion);
 
-    // 注册到待处理请求表
+    std::lock_guard<std::mutex> lock(mutex_);
+    context->sequence = sequence_++;
+    auto &queue = pending_requests_[context->key];
+    context->started = queue.empty() || !context->key.ambiguous();
+    send_now = context->started;
+    if (!send_now)
     {
+        std::copy(frame, frame + size, context->frame.begin());
+        context->frame_size = size;
+    }
+    queue.push_back(context);
+    return context;
+}
+
+/**
+ * @brief 从队列中移除请求，调用方须持有mutex_
+ * @param slot 请求所在的匹配键槽位
+ * @param it 请求在队列中的位置
+ * @return 因此可以发送的暂缓请求(已标记为started)，没有时为空
+ */
+std::shared_ptr<ModbusUdpMaster::Impl::RequestContext>
+ModbusUdpMaster::Impl::erase_locked(PendingMap::iterator slot,
+                                    std::deque<std::shared_ptr<RequestContext>>::iterator it)
+{
+    auto &queue = slot->second;
+    queue.erase(it);
+    if (queue.empty())
+    {
+        pending_requests_.erase(slot);
+        return nullptr;
+    }
+
+    auto &next = queue.front();
+    if (next->started)
+        return nullptr;
+    next->started = true;
+    return next;
+}
+
+/**
+ * @brief 发送此前暂缓的请求
+ * @param context 已标记为started的请求上下文，为空时不做任何事
+ * @note 发送失败的请求最后统一以异常结束，回调中释放主站后不再访问成员
+ */
+void ModbusUdpMaster::Impl::send_held(std::shared_ptr<RequestContext> context)
+{
+    std::vector<std::shared_ptr<RequestContext>> failed;
+    while (context && !endpoint_->send(*peer_, context->frame.data(), context->frame_size))
+    {
+        // 发送失败的请求仍在队首(超时方取走时不再处理)，取出后尝试下一个
         std::lock_guard<std::mutex> lock(mutex_);
-        pending_requests_[tid] = context;
+        auto slot = pending_requests_.find(context->key);
+        if (slot == pending_requests_.end() || slot->second.front() != context)
+            break;
+        failed.push_back(std::move(context));
+        context = erase_locked(slot, slot->second.begin());
+    }
+
+    auto error = std::make_exception_ptr(std::runtime_error("Failed to send Modbus request"));
+    for (auto &request : failed)
+    {
+        request->completion(ModbusResponse(), error);
     }
+}
 
-    // 构建请求帧
-    std::vector<uint8_t> frame = SsModbusMaster::build_request_frame(request);
+/**
+ * @brief 登记请求并发送
+ * @param request Modbus请求
+ * @param frame 完整请求帧
+ * @param size 帧长度
+ * @param timeout 超时时间
+ * @param completion 完成回调
+ * @return 请求上下文
+ * @throw std::runtime_error 发送失败，此时请求已注销且回调不会被调用
+ */
+std::shared_ptr<ModbusUdpMaster::Impl::RequestContext>
+ModbusUdpMaster::Impl::start_request(const ModbusRequest &request,
+                                     const uint8_t *frame, size_t size,
+                                     std::chrono::milliseconds timeout,
+                                     SsModbusMaster::ResponseCallback completion)
+{
+    bool send_now = false;
+    auto context = register_request(request, frame, size, timeout, std::move(completion), send_now);
+    if (!send_now)
+        return context;
 
     // 发送请求
-    if (::communicate::SendGeneralMessage(targetIp_.c_str(), targetPort_,
-                                          frame.data(), frame.size()) != 0)
+    if (!endpoint_->send(*peer_, frame, size))
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_requests_.erase(tid);
+        remove_pending(context, false);
         throw std::runtime_error("Failed to send Modbus request");
     }
+    return context;
+}
 
-    // 轮询等待响应或超时
-    auto end_time = std::chrono::steady_clock::now() + timeout;
-
-    while (std::chrono::steady_clock::now() < end_time)
+/**
+ * @brief 从待处理表中移除请求
+ * @details 已发出的读请求超时后，其响应仍可能迟到并被当作下一个同键请求的响应；
+ *          因此该请求留在队首作为占位，直到收到迟到的响应(丢弃)或再经过一个超时周期，
+ *          之后才发出下一个同键请求
+ * @param context 请求上下文
+ * @param sent 请求是否已发出(可能有响应到达)
+ * @return true请求仍未完成并已移除，false已被响应回调取走
+ */
+bool ModbusUdpMaster::Impl::remove_pending(const std::shared_ptr<RequestContext> &context, bool sent)
+{
+    std::shared_ptr<RequestContext> next;
+    bool keep_placeholder = false;
     {
-        // 处理响应队列
-        std::vector<ResponseMessage> messages_to_process;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto slot = pending_requests_.find(context->key);
+        if (slot == pending_requests_.end())
+            return false;
+
+        auto &queue = slot->second;
+        auto it = std::find(queue.begin(), queue.end(), context);
+        if (it == queue.end() || context->expired)
+            return false;
+
+        keep_placeholder = sent && context->started && context->key.ambiguous();
+        if (keep_placeholder)
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            while (!response_queue_.empty())
-            {
-                messages_to_process.push_back(std::move(response_queue_.front()));
-                response_queue_.pop();
-            }
+            context->expired = true;
         }
-
-        // 处理所有响应消息
-        for (auto &msg : messages_to_process)
+        else
         {
-            ModbusResponse response;
-            if (process_response_data(msg.data.data(), msg.data.size(), response))
+            next = erase_locked(slot, it);
+        }
+    }
+
+    if (keep_placeholder)
+    {
+        std::weak_ptr<RequestContext> weak = context;
+        endpoint_->schedule(peer_, std::chrono::steady_clock::now() + context->timeout, [this, weak]() {
+            auto placeholder = weak.lock();
+            if (!placeholder)
+                return;
+
+            std::shared_ptr<RequestContext> next;
             {
-                // 查找匹配的请求
                 std::lock_guard<std::mutex> lock(mutex_);
-                for (auto &pair : pending_requests_)
-                {
-                    auto &ctx = pair.second;
-                    if (ctx->transaction_id == tid && !ctx->response_received)
-                    {
-                        ctx->response = response;
-                        ctx->response_received = true;
-                        ctx->processed = true;
-                        return response;
-                    }
-                }
+                auto slot = pending_requests_.find(placeholder->key);
+                if (slot == pending_requests_.end() || slot->second.front() != placeholder)
+                    return;
+                next = erase_locked(slot, slot->second.begin());
             }
+            send_held(std::move(next));
+        });
+        return true;
+    }
+
+    send_held(std::move(next));
+    return true;
+}
+
+/**
+ * @brief 由请求生成匹配键
+ * @param request Modbus请求
+ * @return 匹配键，与对应正常响应的匹配键相同
+ */
+ModbusUdpMaster::Impl::MatchKey ModbusUdpMaster::Impl::make_request_key(const ModbusRequest &request)
+{
+    MatchKey key{request.slave_address, static_cast<uint8_t>(request.function_code), 0, 0};
+    switch (request.function_code)
+    {
+    case FunctionCode::READ_HOLDING_REGISTERS:
+    case FunctionCode::READ_INPUT_REGISTERS:
+        // 响应不回显地址，仅能以字节数区分
+        key.quantity = request.register_count * 2;
+        break;
+
+    case FunctionCode::WRITE_SINGLE_REGISTER:
+        key.address = request.start_address;
+        key.quantity = request.values.empty() ? 0 : request.values[0];
+        break;
+
+    case FunctionCode::WRITE_MULTIPLE_REGISTERS:
+        key.address = request.start_address;
+        key.quantity = request.register_count;
+        break;
+
+    default:
+        break;
+    }
+    return key;
+}
+
+/**
+ * @brief 由响应帧生成匹配键
+ * @param data 已通过校验的响应帧
+ * @param size 帧长度
+ * @return 匹配键，异常响应只有从站地址和功能码有效
+ */
+ModbusUdpMaster::Impl::MatchKey ModbusUdpMaster::Impl::make_response_key(const uint8_t *data, size_t size)
+{
+    MatchKey key{data[0], static_cast<uint8_t>(data[1] & 0x7F), 0, 0};
+    if (data[1] & 0x80)
+        return key;
+
+    switch (static_cast<FunctionCode>(data[1]))
+    {
+    case FunctionCode::READ_HOLDING_REGISTERS:
+    case FunctionCode::READ_INPUT_REGISTERS:
+        key.quantity = data[2];
+        break;
+
+    case FunctionCode::WRITE_SINGLE_REGISTER:
+    case FunctionCode::WRITE_MULTIPLE_REGISTERS:
+        if (size >= 6)
+        {
+            key.address = (data[2] << 8) | data[3];
+            key.quantity = (data[4] << 8) | data[5];
         }
+        break;
+
+    default:
+        break;
+    }
+    return key;
+}
+
+/**
+ * @brief 取出与响应匹配的最早请求
+ * @param data 已通过校验的响应帧
+ * @param size 帧长度
+ * @param next 输出因此可以发送的暂缓请求
+ * @return 匹配的请求上下文，无匹配或为迟到响应时为空
+ */
+std::shared_ptr<ModbusUdpMaster::Impl::RequestContext>
+ModbusUdpMaster::Impl::take_matching(const uint8_t *data, size_t size, std::shared_ptr<RequestContext> &next)
+{
+    MatchKey key = make_response_key(data, size);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto slot = pending_requests_.end();
 
-        // 检查当前请求是否已经完成
+    if (data[1] & 0x80)
+    {
+        // 异常响应不含回显字段，取同一从站同一功能码下最早发出的请求
+        auto it = pending_requests_.lower_bound(MatchKey{key.slave_address, key.function_code, 0, 0});
+        for (; it != pending_requests_.end() &&
+               it->first.slave_address == key.slave_address &&
+               it->first.function_code == key.function_code;
+             ++it)
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto it = pending_requests_.find(tid);
-            if (it != pending_requests_.end() && it->second->response_received)
+            if (slot == pending_requests_.end() ||
+                it->second.front()->sequence < slot->second.front()->sequence)
             {
-                ModbusResponse response = it->second->response;
-                pending_requests_.erase(it);
-                return response;
+                slot = it;
             }
         }
-
-        // 短暂休眠，避免CPU占用过高
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
-
-    // 超时处理
+    else
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_requests_.erase(tid);
-        throw std::runtime_error("Response timeout");
+        slot = pending_requests_.find(key);
     }
+
+    if (slot == pending_requests_.end())
+        return nullptr;
+
+    // 匹配到超时占位时，该响应是迟到的响应，丢弃
+    auto context = slot->second.front();
+    next = erase_locked(slot, slot->second.begin());
+    return context->expired ? nullptr : context;
 }
 
 /**
  * @brief 处理接收到的响应消息
- * @param msg 原始消息数据
+ * @param data 数据报内容
+ * @param size 数据报长度
  * @return 处理结果：0成功，-1失败
  */
-int ModbusUdpMaster::Impl::handle_response(std::shared_ptr<void> msg)
+int ModbusUdpMaster::Impl::handle_response(const uint8_t *data, size_t size)
 {
-    if (!msg)
-        return -1;
-
-    uint8_t *data = static_cast<uint8_t *>(msg.get());
-    size_t size = SsModbusMaster::get_actual_message_length(data);
-
     // 基本校验
-    if (size < 4)
+    if (size < 5)
         return -1;
 
-    // 将响应消息加入队列
-    ResponseMessage response_msg;
-    response_msg.data.assign(data, data + size);
-    response_msg.receive_time = std::chrono::steady_clock::now();
+    ModbusResponse response;
+    if (!process_response_data(data, size, response))
+        return -1;
 
+    // 交给匹配的待处理请求，先发出同键暂缓的请求，再完成该请求
+    std::shared_ptr<RequestContext> next;
+    auto context = take_matching(data, size, next);
+    if (!context)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        response_queue_.push(std::move(response_msg));
+        send_held(std::move(next));
+        return -1;
     }
+    send_held(std::move(next));
+    context->completion(response, nullptr);
 
     return 0;
 }
@@ -304,15 +753,20 @@ bool ModbusUdpMaster::Impl::process_response_data(const uint8_t *data, size_t si
         default:
             return false;
         }
+
+        response.error = ModbusError::NO_ERROR;
     }
 
-    response.error = ModbusError::NO_ERROR;
     return true;
 }
 
 // ModbusUdpMaster成员函数实现
 ModbusUdpMaster::ModbusUdpMaster(const std::string &ip, uint16_t port)
-    : impl_(std::make_unique<Impl>(ip, port)) {}
+    : impl_(std::make_unique<Impl>(ModbusUdpEndpoint::shared_default(), ip, port)) {}
+
+ModbusUdpMaster::ModbusUdpMaster(std::shared_ptr<ModbusUdpEndpoint> endpoint,
+                                 const std::string &ip, uint16_t port)
+    : impl_(std::make_unique<Impl>(std::move(endpoint), ip, port)) {}
 
 ModbusUdpMaster::~ModbusUdpMaster() = default;
 
@@ -322,4 +776,25 @@ ModbusResponse ModbusUdpMaster::send_request(const ModbusRequest &request,
     return impl_->send_request(request, timeout);
 }
 
+void ModbusUdpMaster::send_request_async(const ModbusRequest &request,
+                                         std::chrono::milliseconds timeout,
+                                         ResponseCallback callback)
+{
+    impl_->send_request_async(request, timeout, std::move(callback));
+}
+
+void ModbusUdpMaster::send_requests(const ModbusRequest *requests, size_t count,
+                                    std::chrono::milliseconds timeout,
+                                    ModbusResponse *responses, std::exception_ptr *errors)
+{
+    impl_->send_requests(requests, count, timeout, responses, errors);
+}
+
+ModbusResponse ModbusUdpMaster::send_encoded_request(const ModbusRequest &request,
+                                                     const uint8_t *frame, size_t size,
+                                                     std::chrono::milliseconds timeout)
+{
+    return impl_->send_frame(request, frame, size, timeout);
+}
+
 } // namespace modbus
\ No newline at end of file
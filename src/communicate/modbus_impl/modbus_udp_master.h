@@ -9,19 +9,37 @@
 #include <memory>
 #include <chrono>
 #include "modbus_master.h"
+#include "modbus_udp_endpoint.h"
 
 namespace modbus
 {
 
+/**
+ * @brief Modbus UDP主站(RTU帧)
+ * @details 报文中没有事务ID，响应按 (从站地址, 功能码, 回显字段) 与请求匹配。
+ *          读响应不回显地址，同一从站、功能码和数量的读请求依次发送，不会并发在途；
+ *          已发出的读请求超时后再占用一个超时周期，期间到达的同键响应作为迟到响应丢弃。
+ * @warning 设备响应晚于两倍超时时间时，该响应仍可能被交给下一个同键读请求，
+ *          调用方会得到其他地址的数据；超时时间应大于设备的最大响应时间
+ */
 class ModbusUdpMaster : public SsModbusMaster
 {
 public:
     /**
-     * @brief 构造函数
+     * @brief 构造函数，挂接到进程内默认共享端点
      * @param ip 目标设备IP地址
      * @param port 目标设备端口号
      */
     explicit ModbusUdpMaster(const std::string &ip, uint16_t port);
+
+    /**
+     * @brief 构造函数，挂接到指定的共享端点
+     * @param endpoint 本地UDP端点，可由多个主站共用
+     * @param ip 目标设备IP地址
+     * @param port 目标设备端口号
+     * @throw std::invalid_argument 如果该设备已挂接在此端点上
+     */
+    ModbusUdpMaster(std::shared_ptr<ModbusUdpEndpoint> endpoint, const std::string &ip, uint16_t port);
     ~ModbusUdpMaster() override;
 
     /**
@@ -34,6 +52,35 @@ public:
     ModbusResponse send_request(const ModbusRequest &request,
                                 std::chrono::milliseconds timeout) override;
 
+    using SsModbusMaster::send_requests;
+
+    /**
+     * @brief 批量发送请求
+     * @note 全部数据报一次性发出(Linux下使用sendmmsg)，响应按到达顺序匹配，
+     *       整批耗时约为一次往返加各帧传输时间；超时从整批发出时开始计算。
+     *       匹配键相同的读请求不在同一批中发出，而是依次发送，共用同一超时
+     */
+    void send_requests(const ModbusRequest *requests, size_t count,
+                       std::chrono::milliseconds timeout,
+                       ModbusResponse *responses, std::exception_ptr *errors) override;
+
+    using SsModbusMaster::send_request_async;
+
+    /**
+     * @brief 异步发送Modbus请求，不占用调用线程
+     * @note 回调在共享端点的接收线程上执行，同一端点上的所有设备共用该线程。
+     *       回调中可以发起异步请求或释放主站，但不能调用同步接口(send_request等)，
+     *       否则会阻塞接收线程直到超时
+     */
+    void send_request_async(const ModbusRequest &request,
+                            std::chrono::milliseconds timeout,
+                            ResponseCallback callback) override;
+
+protected:
+    ModbusResponse send_encoded_request(const ModbusRequest &request,
+                                        const uint8_t *frame, size_t size,
+                                        std::chrono::milliseconds timeout) override;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
@@ -4,28 +4,58 @@
  */
 
 #include "modbus_master.h"
+#include "modbus_crc.h"
 #include <stdexcept>
 
 namespace modbus
 {
 
-std::vector<uint16_t> SsModbusMaster::read_holding_registers(uint8_t slave_address,
-                                                             uint16_t start_address,
-                                                             uint16_t register_count,
-                                                             std::chrono::milliseconds timeout)
+namespace
+{
+
+ModbusRequest make_read_request(uint8_t slave_address, uint16_t start_address, uint16_t register_count)
 {
     ModbusRequest request;
     request.slave_address = slave_address;
     request.function_code = FunctionCode::READ_HOLDING_REGISTERS;
     request.start_address = start_address;
     request.register_count = register_count;
+    return request;
+}
 
-    ModbusResponse response = send_request(request, timeout);
+ModbusRequest make_single_write_request(uint8_t slave_address, uint16_t address, uint16_t value)
+{
+    ModbusRequest request;
+    request.slave_address = slave_address;
+    request.function_code = FunctionCode::WRITE_SINGLE_REGISTER;
+    request.start_address = address;
+    request.values = {value};
+    return request;
+}
+
+ModbusRequest make_multiple_write_request(uint8_t slave_address, uint16_t start_address,
+                                          const std::vector<uint16_t> &values)
+{
+    ModbusRequest request;
+    request.slave_address = slave_address;
+    request.function_code = FunctionCode::WRITE_MULTIPLE_REGISTERS;
+    request.start_address = start_address;
+    request.register_count = values.size();
+    request.values = values;
+    return request;
+}
 
+void check_response(const ModbusResponse &response)
+{
     if (response.error != ModbusError::NO_ERROR)
     {
         throw std::runtime_error("Modbus error: " + std::to_string(static_cast<int>(response.error)));
     }
+}
+
+std::vector<uint16_t> decode_registers(const ModbusResponse &response, uint16_t register_count)
+{
+    check_response(response);
 
     if (response.data.size() != register_count * 2)
     {
@@ -42,23 +72,43 @@ std::vector<uint16_t> SsModbusMaster::read_holding_registers(uint8_t slave_addre
     return result;
 }
 
+// 将写入回调适配为请求回调
+SsModbusMaster::ResponseCallback write_completion(SsModbusMaster::WriteCallback callback)
+{
+    return [callback = std::move(callback)](const ModbusResponse &response, std::exception_ptr error) {
+        if (!error)
+        {
+            try
+            {
+                check_response(response);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        }
+        callback(error);
+    };
+}
+
+} // namespace
+
+std::vector<uint16_t> SsModbusMaster::read_holding_registers(uint8_t slave_address,
+                                                             uint16_t start_address,
+                                                             uint16_t register_count,
+                                                             std::chrono::milliseconds timeout)
+{
+    ModbusResponse response = send_request(make_read_request(slave_address, start_address, register_count),
+                                           timeout);
+    return decode_registers(response, register_count);
+}
+
 void SsModbusMaster::write_single_register(uint8_t slave_address,
                                            uint16_t address,
                                            uint16_t value,
                                            std::chrono::milliseconds timeout)
 {
-    ModbusRequest request;
-    request.slave_address = slave_address;
-    request.function_code = FunctionCode::WRITE_SINGLE_REGISTER;
-    request.start_address = address;
-    request.values = {value};
-
-    ModbusResponse response = send_request(request, timeout);
-
-    if (response.error != ModbusError::NO_ERROR)
-    {
-        throw std::runtime_error("Modbus error: " + std::to_string(static_cast<int>(response.error)));
-    }
+    check_response(send_request(make_single_write_request(slave_address, address, value), timeout));
 }
 
 void SsModbusMaster::write_multiple_registers(uint8_t slave_address,
@@ -66,36 +116,227 @@ void SsModbusMaster::write_multiple_registers(uint8_t slave_address,
                                               const std::vector<uint16_t> &values,
                                               std::chrono::milliseconds timeout)
 {
-    ModbusRequest request;
-    request.slave_address = slave_address;
-    request.function_code = FunctionCode::WRITE_MULTIPLE_REGISTERS;
-    request.start_address = start_address;
-    request.register_count = values.size();
-    request.values = values;
+    check_response(send_request(make_multiple_write_request(slave_address, start_address, values), timeout));
+}
+
+void SsModbusMaster::send_request_async(const ModbusRequest &request,
+                                        std::chrono::milliseconds timeout,
+                                        ResponseCallback callback)
+{
+    ModbusResponse response;
+    std::exception_ptr error;
+    try
+    {
+        response = send_request(request, timeout);
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    callback(response, error);
+}
 
-    ModbusResponse response = send_request(request, timeout);
+std::future<ModbusResponse> SsModbusMaster::send_request_async(const ModbusRequest &request,
+                                                               std::chrono::milliseconds timeout)
+{
+    auto promise = std::make_shared<std::promise<ModbusResponse>>();
+    std::future<ModbusResponse> future = promise->get_future();
+    send_request_async(request, timeout, [promise](const ModbusResponse &response, std::exception_ptr error) {
+        if (error)
+        {
+            promise->set_exception(error);
+        }
+        else
+        {
+            promise->set_value(response);
+        }
+    });
+    return future;
+}
 
-    if (response.error != ModbusError::NO_ERROR)
+void SsModbusMaster::send_requests(const ModbusRequest *requests, size_t count,
+                                   std::chrono::milliseconds timeout,
+                                   ModbusResponse *responses, std::exception_ptr *errors)
+{
+    // 先全部提交再逐个等待，支持并发在途的传输可重叠各请求的往返时间
+    std::vector<std::future<ModbusResponse>> futures;
+    futures.reserve(count);
+    for (size_t i = 0; i < count; ++i)
     {
-        throw std::runtime_error("Modbus error: " + std::to_string(static_cast<int>(response.error)));
+        futures.push_back(send_request_async(requests[i], timeout));
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        errors[i] = nullptr;
+        try
+        {
+            responses[i] = futures[i].get();
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
     }
 }
 
-uint16_t SsModbusMaster::calculate_crc(const uint8_t *data, size_t length)
+std::vector<ModbusResponse> SsModbusMaster::send_requests(const std::vector<ModbusRequest> &requests,
+                                                          std::chrono::milliseconds timeout)
 {
-    uint16_t crc = 0xFFFF;
-    for (size_t i = 0; i < length; ++i)
+    std::vector<ModbusResponse> responses(requests.size());
+    std::vector<std::exception_ptr> errors(requests.size());
+    send_requests(requests.data(), requests.size(), timeout, responses.data(), errors.data());
+
+    for (auto &error : errors)
     {
-        crc ^= data[i];
-        for (int j = 0; j < 8; ++j)
+        if (error)
         {
-            if (crc & 0x0001)
-                crc = (crc >> 1) ^ 0xA001;
-            else
-                crc >>= 1;
+            std::rethrow_exception(error);
         }
     }
-    return crc;
+    return responses;
+}
+
+std::future<std::vector<uint16_t>> SsModbusMaster::read_holding_registers_async(uint8_t slave_address,
+                                                                                uint16_t start_address,
+                                                                                uint16_t register_count,
+                                                                                std::chrono::milliseconds timeout)
+{
+    auto promise = std::make_shared<std::promise<std::vector<uint16_t>>>();
+    std::future<std::vector<uint16_t>> future = promise->get_future();
+    read_holding_registers_async(slave_address, start_address, register_count, timeout,
+                                 [promise](std::vector<uint16_t> values, std::exception_ptr error) {
+        if (error)
+        {
+            promise->set_exception(error);
+        }
+        else
+        {
+            promise->set_value(std::move(values));
+        }
+    });
+    return future;
+}
+
+void SsModbusMaster::read_holding_registers_async(uint8_t slave_address,
+                                                  uint16_t start_address,
+                                                  uint16_t register_count,
+                                                  std::chrono::milliseconds timeout,
+                                                  RegistersCallback callback)
+{
+    send_request_async(make_read_request(slave_address, start_address, register_count), timeout,
+                       [register_count, callback = std::move(callback)](const ModbusResponse &response,
+                                                                        std::exception_ptr error) {
+        std::vector<uint16_t> values;
+        if (!error)
+        {
+            try
+            {
+                values = decode_registers(response, register_count);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        }
+        callback(std::move(values), error);
+    });
+}
+
+std::future<void> SsModbusMaster::write_single_register_async(uint8_t slave_address,
+                                                              uint16_t address,
+                                                              uint16_t value,
+                                                              std::chrono::milliseconds timeout)
+{
+    auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+    write_single_register_async(slave_address, address, value, timeout, [promise](std::exception_ptr error) {
+        if (error)
+        {
+            promise->set_exception(error);
+        }
+        else
+        {
+            promise->set_value();
+        }
+    });
+    return future;
+}
+
+void SsModbusMaster::write_single_register_async(uint8_t slave_address,
+                                                 uint16_t address,
+                                                 uint16_t value,
+                                                 std::chrono::milliseconds timeout,
+                                                 WriteCallback callback)
+{
+    send_request_async(make_single_write_request(slave_address, address, value), timeout,
+                       write_completion(std::move(callback)));
+}
+
+std::future<void> SsModbusMaster::write_multiple_registers_async(uint8_t slave_address,
+                                                                 uint16_t start_address,
+                                                                 const std::vector<uint16_t> &values,
+                                                                 std::chrono::milliseconds timeout)
+{
+    auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+    write_multiple_registers_async(slave_address, start_address, values, timeout,
+                                   [promise](std::exception_ptr error) {
+        if (error)
+        {
+            promise->set_exception(error);
+        }
+        else
+        {
+            promise->set_value();
+        }
+    });
+    return future;
+}
+
+void SsModbusMaster::write_multiple_registers_async(uint8_t slave_address,
+                                                    uint16_t start_address,
+                                                    const std::vector<uint16_t> &values,
+                                                    std::chrono::milliseconds timeout,
+                                                    WriteCallback callback)
+{
+    send_request_async(make_multiple_write_request(slave_address, start_address, values), timeout,
+                       write_completion(std::move(callback)));
+}
+
+ModbusResponse SsModbusMaster::send_prebuilt_request(const FixedRequestFrame &frame,
+                                                     std::chrono::milliseconds timeout)
+{
+    // 从帧内容还原请求，供响应解析使用
+    ModbusRequest request;
+    request.slave_address = frame[0];
+    request.function_code = static_cast<FunctionCode>(frame[1]);
+    request.start_address = (frame[2] << 8) | frame[3];
+
+    uint16_t quantity = (frame[4] << 8) | frame[5];
+    if (request.function_code == FunctionCode::WRITE_SINGLE_REGISTER)
+    {
+        request.register_count = 1;
+        request.values = {quantity};
+    }
+    else
+    {
+        request.register_count = quantity;
+    }
+
+    return send_encoded_request(request, frame.data(), frame.size(), timeout);
+}
+
+ModbusResponse SsModbusMaster::send_encoded_request(const ModbusRequest &request,
+                                                    const uint8_t *, size_t,
+                                                    std::chrono::milliseconds timeout)
+{
+    return send_request(request, timeout);
+}
+
+uint16_t SsModbusMaster::calculate_crc(const uint8_t *data, size_t length)
+{
+    return crc16(data, length);
 }
 
 bool SsModbusMaster::verify_crc(const uint8_t *data, size_t length)
@@ -107,22 +348,55 @@ bool SsModbusMaster::verify_crc(const uint8_t *data, size_t length)
     return calculate_crc(data, length - 2) == received_crc;
 }
 
-// 添加16位数据到大端字节流
-void append_uint16(std::vector<uint8_t> &frame, uint16_t value)
+std::vector<uint8_t> SsModbusMaster::build_request_frame(const ModbusRequest &request)
 {
-    frame.push_back((value >> 8) & 0xFF);
-    frame.push_back(value & 0xFF);
+    RequestFrameBuffer buffer;
+    size_t size = encode_request_frame(request, buffer.data(), buffer.size());
+    return std::vector<uint8_t>(buffer.begin(), buffer.begin() + size);
 }
 
-std::vector<uint8_t> SsModbusMaster::build_request_frame(const ModbusRequest &request)
+size_t SsModbusMaster::encode_request_frame(const ModbusRequest &request, uint8_t *buffer, size_t capacity)
 {
-    std::vector<uint8_t> frame;
+    // 先计算帧长度，保证后续写入不越界
+    size_t size;
+    switch (request.function_code)
+    {
+    case FunctionCode::READ_HOLDING_REGISTERS:
+    case FunctionCode::READ_INPUT_REGISTERS:
+        size = 8;
+        break;
+
+    case FunctionCode::WRITE_SINGLE_REGISTER:
+        if (request.values.empty())
+            throw std::invalid_argument("Missing register value");
+        size = 8;
+        break;
+
+    case FunctionCode::WRITE_MULTIPLE_REGISTERS:
+        if (request.values.empty() || request.values.size() > MAX_WRITE_REGISTERS ||
+            request.values.size() != request.register_count)
+            throw std::invalid_argument("Register values must match count (1-123)");
+        size = 9 + request.values.size() * 2;
+        break;
+
+    default:
+        throw std::runtime_error("Unsupported function code");
+    }
+
+    if (capacity < size)
+        throw std::invalid_argument("Frame buffer too small");
+
+    size_t pos = 0;
+    auto put_uint16 = [&](uint16_t value) {
+        buffer[pos++] = (value >> 8) & 0xFF;
+        buffer[pos++] = value & 0xFF;
+    };
 
     // 地址域
-    frame.push_back(request.slave_address);
+    buffer[pos++] = request.slave_address;
 
     // 功能码
-    frame.push_back(static_cast<uint8_t>(request.function_code));
+    buffer[pos++] = static_cast<uint8_t>(request.function_code);
 
     // 数据域 (根据功能码不同)
     switch (request.function_code)
@@ -130,44 +404,49 @@ std::vector<uint8_t> SsModbusMaster::build_request_frame(const ModbusRequest &re
     case FunctionCode::READ_HOLDING_REGISTERS:
     case FunctionCode::READ_INPUT_REGISTERS:
         // 寄存器地址(2字节) + 数量(2字节)
-        append_uint16(frame, request.start_address);
-        append_uint16(frame, request.register_count);
+        put_uint16(request.start_address);
+        put_uint16(request.register_count);
         break;
 
     case FunctionCode::WRITE_SINGLE_REGISTER:
         // 寄存器地址(2字节) + 值(2字节)
-        append_uint16(frame, request.start_address);
-        append_uint16(frame, request.values[0]);
+        put_uint16(request.start_address);
+        put_uint16(request.values[0]);
         break;
 
     case FunctionCode::WRITE_MULTIPLE_REGISTERS:
         // 寄存器地址(2字节) + 数量(2字节) + 字节数(1字节) + 值(n字节)
-        append_uint16(frame, request.start_address);
-        append_uint16(frame, request.register_count);
-        frame.push_back(request.values.size() * 2);
+        put_uint16(request.start_address);
+        put_uint16(request.register_count);
+        buffer[pos++] = static_cast<uint8_t>(request.values.size() * 2);
         for (uint16_t value : request.values)
         {
-            append_uint16(frame, value);
+            put_uint16(value);
         }
         break;
 
     default:
-        throw std::runtime_error("Unsupported function code");
+        break;
     }
 
     // 添加CRC校验
-    uint16_t crc = calculate_crc(frame.data(), frame.size());
-    frame.push_back(crc & 0xFF);
-    frame.push_back((crc >> 8) & 0xFF);
+    uint16_t crc = calculate_crc(buffer, pos);
+    buffer[pos++] = crc & 0xFF;
+    buffer[pos++] = (crc >> 8) & 0xFF;
 
-    return frame;
+    return pos;
 }
 
 size_t SsModbusMaster::get_actual_message_length(const uint8_t *data)
 {
+    // 异常响应: 地址 + 功能码 + 异常码 + CRC
+    if (data[1] & 0x80)
+        return 5;
+
     switch (data[1])
     {
     case 0x03: // 读取保持寄存器
+    case 0x04: // 读取输入寄存器
         return 3 + data[2] + 2;
     case 0x06: // 写单个寄存器
     case 0x10: // 写多个寄存器
@@ -177,4 +456,21 @@ size_t SsModbusMaster::get_actual_message_length(const uint8_t *data)
     }
 }
 
+size_t SsModbusMaster::get_expected_response_length(const ModbusRequest &request)
+{
+    switch (request.function_code)
+    {
+    case FunctionCode::READ_HOLDING_REGISTERS:
+    case FunctionCode::READ_INPUT_REGISTERS:
+        // 地址 + 功能码 + 字节数 + 数据 + CRC
+        return 3 + request.register_count * 2 + 2;
+    case FunctionCode::WRITE_SINGLE_REGISTER:
+    case FunctionCode::WRITE_MULTIPLE_REGISTERS:
+        // 地址 + 功能码 + 地址(2) + 值/数量(2) + CRC
+        return 8;
+    default:
+        return 0;
+    }
+}
+
 } // namespace modbus
\ No newline at end of file
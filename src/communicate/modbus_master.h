@@ -5,9 +5,14 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
 #include <vector>
 
+#include "modbus_frame.h"
 #include "modbus_types.h"
 
 namespace modbus
@@ -19,6 +24,19 @@ namespace modbus
 class SsModbusMaster
 {
 public:
+    /**
+     * @brief 异步请求完成回调
+     * @param response 响应数据，error非空时无意义
+     * @param error 请求失败(超时、连接断开等)时的异常
+     */
+    using ResponseCallback = std::function<void(const ModbusResponse &response, std::exception_ptr error)>;
+
+    /// 异步读取寄存器完成回调，error非空时values无意义
+    using RegistersCallback = std::function<void(std::vector<uint16_t> values, std::exception_ptr error)>;
+
+    /// 异步写入完成回调，写入成功时error为空
+    using WriteCallback = std::function<void(std::exception_ptr error)>;
+
     virtual ~SsModbusMaster() = default;
 
     /**
@@ -30,6 +48,16 @@ public:
     virtual ModbusResponse send_request(const ModbusRequest &request,
                                         std::chrono::milliseconds timeout) = 0;
 
+    /**
+     * @brief 发送预先构造好的定长请求帧
+     * @param frame 由 make_request_frame 生成的完整请求帧(含CRC)
+     * @param timeout 超时时间
+     * @return 响应数据
+     * @note 帧原样发送，不再重新编码和计算CRC
+     */
+    ModbusResponse send_prebuilt_request(const FixedRequestFrame &frame,
+                                         std::chrono::milliseconds timeout);
+
     /**
      * @brief 读取保持寄存器
      * @param slave_address 从站地址
@@ -67,7 +95,118 @@ public:
                                           const std::vector<uint16_t> &values,
                                           std::chrono::milliseconds timeout);
 
+    /**
+     * @brief 异步发送Modbus请求
+     * @param request 请求数据
+     * @param timeout 超时时间
+     * @param callback 完成回调，恰好调用一次
+     * @note 默认实现在调用线程上同步执行 send_request 后调用回调；
+     *       UDP/TCP在各自的io线程上完成回调，不占用调用线程，RTU经总线工作线程串行执行。
+     *       回调不应阻塞，也不应在回调中同步调用同一主站。
+     *       派生类重写时须以 using SsModbusMaster::send_request_async 保留其余重载
+     */
+    virtual void send_request_async(const ModbusRequest &request,
+                                    std::chrono::milliseconds timeout,
+                                    ResponseCallback callback);
+
+    /**
+     * @brief 异步发送Modbus请求
+     * @return 响应的future，失败时抛出与 send_request 相同的异常
+     */
+    std::future<ModbusResponse> send_request_async(const ModbusRequest &request,
+                                                   std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 批量发送请求
+     * @param requests 请求数组
+     * @param count 请求数量
+     * @param timeout 每个请求的超时时间
+     * @param responses 输出的响应数组，长度不小于count，失败的请求对应项无意义
+     * @param errors 输出的异常数组，长度不小于count，成功的请求对应项为空
+     * @note 默认实现经 send_request_async 同时提交全部请求后等待，TCP在同一连接上流水线执行；
+     *       RTU在一次占用总线期间逐个收发，UDP一次性发出全部数据报后统一收集响应。
+     *       派生类重写时须以 using SsModbusMaster::send_requests 保留其余重载
+     */
+    virtual void send_requests(const ModbusRequest *requests, size_t count,
+                               std::chrono::milliseconds timeout,
+                               ModbusResponse *responses, std::exception_ptr *errors);
+
+    /**
+     * @brief 批量发送请求
+     * @param requests 请求列表
+     * @param timeout 每个请求的超时时间
+     * @return 与请求一一对应的响应
+     * @throw 全部请求结束后，若有请求失败则抛出第一个失败请求的异常
+     */
+    std::vector<ModbusResponse> send_requests(const std::vector<ModbusRequest> &requests,
+                                              std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 异步读取保持寄存器
+     * @return 寄存器值的future，失败时抛出与 read_holding_registers 相同的异常
+     */
+    std::future<std::vector<uint16_t>> read_holding_registers_async(uint8_t slave_address,
+                                                                    uint16_t start_address,
+                                                                    uint16_t register_count,
+                                                                    std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 异步读取保持寄存器，完成后调用回调
+     */
+    void read_holding_registers_async(uint8_t slave_address,
+                                      uint16_t start_address,
+                                      uint16_t register_count,
+                                      std::chrono::milliseconds timeout,
+                                      RegistersCallback callback);
+
+    /**
+     * @brief 异步写入单个寄存器
+     */
+    std::future<void> write_single_register_async(uint8_t slave_address,
+                                                  uint16_t address,
+                                                  uint16_t value,
+                                                  std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 异步写入单个寄存器，完成后调用回调
+     */
+    void write_single_register_async(uint8_t slave_address,
+                                     uint16_t address,
+                                     uint16_t value,
+                                     std::chrono::milliseconds timeout,
+                                     WriteCallback callback);
+
+    /**
+     * @brief 异步写入多个寄存器
+     */
+    std::future<void> write_multiple_registers_async(uint8_t slave_address,
+                                                     uint16_t start_address,
+                                                     const std::vector<uint16_t> &values,
+                                                     std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 异步写入多个寄存器，完成后调用回调
+     */
+    void write_multiple_registers_async(uint8_t slave_address,
+                                        uint16_t start_address,
+                                        const std::vector<uint16_t> &values,
+                                        std::chrono::milliseconds timeout,
+                                        WriteCallback callback);
+
 protected:
+    /**
+     * @brief 发送已编码的请求帧
+     * @param request 与帧内容一致的请求数据，用于解析响应
+     * @param frame 完整RTU请求帧(含CRC)
+     * @param size 帧长度
+     * @param timeout 超时时间
+     * @return 响应数据
+     * @note 默认实现忽略已编码帧，转调 send_request 重新编码；各传输层应重写以直接发送
+     */
+    virtual ModbusResponse send_encoded_request(const ModbusRequest &request,
+                                                const uint8_t *frame, size_t size,
+                                                std::chrono::milliseconds timeout);
+
     /**
      * @brief 计算获取 crc 值
      * @param data 计算目标数据
@@ -91,12 +230,33 @@ protected:
      */
     static std::vector<uint8_t> build_request_frame(const ModbusRequest &request);
 
+    /**
+     * @brief 将请求帧编码到调用方提供的缓冲区，不分配内存
+     * @param request 请求的数据结构
+     * @param buffer 输出缓冲区
+     * @param capacity 缓冲区容量，使用 RequestFrameBuffer 时总是足够
+     * @return 编码后的帧长度(含CRC)
+     * @throw std::invalid_argument 请求内容非法或缓冲区不足
+     */
+    static size_t encode_request_frame(const ModbusRequest &request, uint8_t *buffer, size_t capacity);
+
+    /// 可容纳任意RTU请求帧的定长缓冲区
+    using RequestFrameBuffer = std::array<uint8_t, MAX_RTU_FRAME_SIZE>;
+
     /**
      * @brief 获取响应消息整体长度
      * @param data 接收到的数据指针
      * @return 消息长度
      */
     static size_t get_actual_message_length(const uint8_t *data);
+
+    /**
+     * @brief 由请求计算正常响应的整体长度
+     * @param request 请求的数据结构
+     * @return 响应帧长度(含地址和CRC)，不支持的功能码返回0
+     * @note 异常响应长度固定为5字节，与请求无关
+     */
+    static size_t get_expected_response_length(const ModbusRequest &request);
 };
 
 } // namespace modbus
\ No newline at end of file
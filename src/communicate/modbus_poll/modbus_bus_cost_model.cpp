@@ -0,0 +1,151 @@
+/**
+ * @file modbus_bus_cost_model.cpp
+ * @brief Modbus事务总线占用时间估算实现
+ */
+
+#include "modbus_bus_cost_model.h"
+#include "modbus_impl/modbus_rtu_master.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace modbus
+{
+
+namespace
+{
+
+constexpr double FORGETTING_FACTOR = 0.95;   // 每个新样本对旧样本的衰减系数
+constexpr size_t MIN_FIT_SAMPLES = 4;        // 开始拟合每字节时间所需的最少样本数
+
+// RTU帧长(含地址和CRC)
+size_t request_frame_bytes(const ModbusRequest &request)
+{
+    switch (request.function_code)
+    {
+    case FunctionCode::WRITE_MULTIPLE_COILS:
+        return 9 + (request.register_count + 7u) / 8;
+    case FunctionCode::WRITE_MULTIPLE_REGISTERS:
+        return 9 + request.register_count * 2u;
+    default:
+        return 8;
+    }
+}
+
+size_t response_frame_bytes(const ModbusRequest &request)
+{
+    switch (request.function_code)
+    {
+    case FunctionCode::READ_COILS:
+    case FunctionCode::READ_DISCRETE_INPUTS:
+        return 5 + (request.register_count + 7u) / 8;
+    case FunctionCode::READ_HOLDING_REGISTERS:
+    case FunctionCode::READ_INPUT_REGISTERS:
+        return 5 + request.register_count * 2u;
+    default:
+        return 8;
+    }
+}
+
+} // namespace
+
+ModbusBusCostModel::ModbusBusCostModel(std::chrono::microseconds turnaround)
+    : overhead_us_(static_cast<double>(turnaround.count())),
+      per_byte_us_(0.0)
+{
+}
+
+ModbusBusCostModel::ModbusBusCostModel(uint32_t baudrate, Parity parity, uint8_t stop_bits, uint8_t data_bits,
+                                       std::chrono::microseconds turnaround)
+{
+    if (baudrate == 0)
+    {
+        throw std::invalid_argument("Baudrate must be positive");
+    }
+
+    unsigned bits = 1 + data_bits + (parity == Parity::NONE ? 0 : 1) + stop_bits;
+    char_time_us_ = bits * 1e6 / baudrate;
+
+    // 规范规定波特率高于19200时帧间隔固定为1.75ms
+    silent_interval_us_ = baudrate > 19200 ? 1750.0 : 3.5 * char_time_us_;
+
+    // 请求后和响应后各一个帧间隔
+    overhead_us_ = 2 * silent_interval_us_ + static_cast<double>(turnaround.count());
+    per_byte_us_ = char_time_us_;
+}
+
+ModbusBusCostModel ModbusBusCostModel::for_rtu(const ModbusRtuMaster &master, std::chrono::microseconds turnaround)
+{
+    const SerialConfig &config = master.serial_config();
+    return ModbusBusCostModel(config.baudrate, config.parity, config.stop_bits, config.data_bits, turnaround);
+}
+
+std::chrono::microseconds ModbusBusCostModel::estimate(const ModbusRequest &request) const
+{
+    double us = estimate_us(request_frame_bytes(request), response_frame_bytes(request));
+    return std::chrono::microseconds(static_cast<int64_t>(std::ceil(us)));
+}
+
+std::chrono::microseconds ModbusBusCostModel::estimate_read(uint16_t register_count) const
+{
+    double us = estimate_us(8, 5 + register_count * 2u);
+    return std::chrono::microseconds(static_cast<int64_t>(std::ceil(us)));
+}
+
+double ModbusBusCostModel::estimate_us(size_t request_bytes, size_t response_bytes) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return overhead_us_ + per_byte_us_ * static_cast<double>(request_bytes + response_bytes);
+}
+
+void ModbusBusCostModel::record(const ModbusRequest &request, std::chrono::microseconds measured)
+{
+    if (measured.count() <= 0)
+        return;
+
+    double x = static_cast<double>(request_frame_bytes(request) + response_frame_bytes(request));
+    double y = static_cast<double>(measured.count());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    sum_w_ = sum_w_ * FORGETTING_FACTOR + 1.0;
+    sum_x_ = sum_x_ * FORGETTING_FACTOR + x;
+    sum_y_ = sum_y_ * FORGETTING_FACTOR + y;
+    sum_xx_ = sum_xx_ * FORGETTING_FACTOR + x * x;
+    sum_xy_ = sum_xy_ * FORGETTING_FACTOR + x * y;
+    ++samples_;
+
+    double mean_x = sum_x_ / sum_w_;
+    double mean_y = sum_y_ / sum_w_;
+
+    // 样本中帧长有足够差异时拟合每字节时间，否则只校准固定开销
+    double var_x = sum_xx_ / sum_w_ - mean_x * mean_x;
+    if (samples_ >= MIN_FIT_SAMPLES && var_x > 1.0)
+    {
+        double cov_xy = sum_xy_ / sum_w_ - mean_x * mean_y;
+        // 串口上每字节时间不会低于字符时间
+        per_byte_us_ = std::max(cov_xy / var_x, char_time_us_);
+    }
+    overhead_us_ = std::max(mean_y - per_byte_us_ * mean_x, 0.0);
+}
+
+double ModbusBusCostModel::overhead_us() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return overhead_us_;
+}
+
+double ModbusBusCostModel::per_byte_us() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return per_byte_us_;
+}
+
+size_t ModbusBusCostModel::samples() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return samples_;
+}
+
+} // namespace modbus
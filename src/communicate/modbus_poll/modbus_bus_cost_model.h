@@ -0,0 +1,120 @@
+/**
+ * @file modbus_bus_cost_model.h
+ * @brief Modbus事务总线占用时间估算
+ */
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+
+#include "modbus_master.h"
+
+namespace modbus
+{
+
+class ModbusRtuMaster;
+
+/**
+ * @brief 总线占用时间模型
+ * @details 事务耗时按 固定开销 + 每字节时间 × (请求字节数 + 响应字节数) 估算：
+ *          - 每字节时间初始为串口字符时间(起始位 + 数据位 + 校验位 + 停止位)/波特率
+ *          - 固定开销初始为两个3.5字符静默间隔加从站响应时间
+ *          记录实测往返时间后，以指数遗忘的最小二乘拟合校准两项参数
+ * @note 线程安全
+ */
+class ModbusBusCostModel
+{
+public:
+    /**
+     * @brief 构造网络总线模型，无串口字符时间，全部开销依赖校准
+     * @param turnaround 初始的单次事务固定开销估计
+     */
+    explicit ModbusBusCostModel(std::chrono::microseconds turnaround = std::chrono::microseconds(1000));
+
+    /**
+     * @brief 构造串口总线模型
+     * @param baudrate 波特率
+     * @param parity 校验方式
+     * @param stop_bits 停止位数
+     * @param data_bits 数据位数
+     * @param turnaround 从站响应时间(收到请求到开始应答)的初始估计
+     */
+    ModbusBusCostModel(uint32_t baudrate, Parity parity, uint8_t stop_bits = 1, uint8_t data_bits = 8,
+                       std::chrono::microseconds turnaround = std::chrono::microseconds(1000));
+
+    /**
+     * @brief 按RTU主站的串口参数构造模型
+     */
+    static ModbusBusCostModel for_rtu(const ModbusRtuMaster &master,
+                                      std::chrono::microseconds turnaround = std::chrono::microseconds(1000));
+
+    /**
+     * @brief 估算一次事务的总线占用时间
+     * @param request 请求
+     * @return 估算时间，包含请求、响应、帧间隔和从站响应时间
+     */
+    std::chrono::microseconds estimate(const ModbusRequest &request) const;
+
+    /**
+     * @brief 估算读取指定数量寄存器(FC03/FC04)的总线占用时间
+     */
+    std::chrono::microseconds estimate_read(uint16_t register_count) const;
+
+    /**
+     * @brief 估算收发给定字节数的事务耗时
+     * @param request_bytes 请求帧字节数
+     * @param response_bytes 响应帧字节数
+     */
+    double estimate_us(size_t request_bytes, size_t response_bytes) const;
+
+    /**
+     * @brief 记录一次实测往返时间用于校准
+     * @param request 请求
+     * @param measured 从开始发送到收完响应的实测时间
+     */
+    void record(const ModbusRequest &request, std::chrono::microseconds measured);
+
+    /**
+     * @brief 串口字符时间(微秒)，网络总线为0
+     */
+    double char_time_us() const { return char_time_us_; }
+
+    /**
+     * @brief 3.5字符静默间隔(微秒)，波特率高于19200时按规范固定为1750
+     */
+    double silent_interval_us() const { return silent_interval_us_; }
+
+    /**
+     * @brief 当前的固定开销估计(微秒)
+     */
+    double overhead_us() const;
+
+    /**
+     * @brief 当前的每字节时间估计(微秒)
+     */
+    double per_byte_us() const;
+
+    /**
+     * @brief 已记录的样本数
+     */
+    size_t samples() const;
+
+private:
+    double char_time_us_ = 0.0;       // 字符时间
+    double silent_interval_us_ = 0.0; // 3.5字符静默间隔
+
+    mutable std::mutex mutex_;
+    double overhead_us_;              // 固定开销
+    double per_byte_us_;              // 每字节时间
+
+    // 指数遗忘的加权最小二乘累积量 (x: 字节数, y: 实测时间)
+    double sum_w_ = 0.0;
+    double sum_x_ = 0.0;
+    double sum_y_ = 0.0;
+    double sum_xx_ = 0.0;
+    double sum_xy_ = 0.0;
+    size_t samples_ = 0;
+};
+
+} // namespace modbus
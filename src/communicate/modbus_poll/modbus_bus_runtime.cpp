@@ -0,0 +1,111 @@
+/**
+ * @file modbus_bus_runtime.cpp
+ * @brief 进程级总线工作线程注册表实现
+ */
+
+#include "modbus_bus_runtime.h"
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace modbus
+{
+
+class ModbusBusRuntime::Impl
+{
+public:
+    std::shared_ptr<ModbusBusWorker> worker(const std::shared_ptr<SsModbusMaster> &master)
+    {
+        if (!master)
+        {
+            throw std::invalid_argument("Master must not be null");
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &worker = workers_[master.get()];
+        if (!worker)
+        {
+            worker = std::make_shared<ModbusBusWorker>(master);
+        }
+        return worker;
+    }
+
+    std::shared_ptr<ModbusBusWorker> find(const SsModbusMaster &master) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = workers_.find(&master);
+        return it != workers_.end() ? it->second : nullptr;
+    }
+
+    void release(const SsModbusMaster &master)
+    {
+        std::shared_ptr<ModbusBusWorker> worker;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = workers_.find(&master);
+            if (it == workers_.end())
+                return;
+            worker = std::move(it->second);
+            workers_.erase(it);
+        }
+        // 在锁外释放，工作线程退出时不阻塞其他总线的查找
+    }
+
+    void clear()
+    {
+        std::map<const SsModbusMaster *, std::shared_ptr<ModbusBusWorker>> workers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            workers.swap(workers_);
+        }
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return workers_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<const SsModbusMaster *, std::shared_ptr<ModbusBusWorker>> workers_;
+};
+
+ModbusBusRuntime &ModbusBusRuntime::instance()
+{
+    static ModbusBusRuntime runtime;
+    return runtime;
+}
+
+ModbusBusRuntime::ModbusBusRuntime()
+    : impl_(std::make_unique<Impl>()) {}
+
+ModbusBusRuntime::~ModbusBusRuntime() = default;
+
+std::shared_ptr<ModbusBusWorker> ModbusBusRuntime::worker(const std::shared_ptr<SsModbusMaster> &master)
+{
+    return impl_->worker(master);
+}
+
+std::shared_ptr<ModbusBusWorker> ModbusBusRuntime::find(const SsModbusMaster &master) const
+{
+    return impl_->find(master);
+}
+
+void ModbusBusRuntime::release(const SsModbusMaster &master)
+{
+    impl_->release(master);
+}
+
+void ModbusBusRuntime::clear()
+{
+    impl_->clear();
+}
+
+size_t ModbusBusRuntime::size() const
+{
+    return impl_->size();
+}
+
+} // namespace modbus
@@ -0,0 +1,70 @@
+/**
+ * @file modbus_bus_runtime.h
+ * @brief 进程级总线工作线程注册表
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "modbus_bus_worker.h"
+
+namespace modbus
+{
+
+/**
+ * @brief 总线运行时
+ * @details 为进程中的每个主站维护唯一的工作线程，各模块通过同一主站取得同一工作线程，
+ *          保证一条物理总线上的请求始终经同一队列串行执行
+ * @note 线程安全
+ */
+class ModbusBusRuntime
+{
+public:
+    /**
+     * @brief 获取进程级实例
+     */
+    static ModbusBusRuntime &instance();
+
+    ModbusBusRuntime(const ModbusBusRuntime &) = delete;
+    ModbusBusRuntime &operator=(const ModbusBusRuntime &) = delete;
+
+    /**
+     * @brief 获取主站的工作线程，不存在时创建
+     * @param master 总线主站
+     * @return 工作线程
+     * @throw std::invalid_argument 当master为空
+     */
+    std::shared_ptr<ModbusBusWorker> worker(const std::shared_ptr<SsModbusMaster> &master);
+
+    /**
+     * @brief 查找主站的工作线程
+     * @return 工作线程，未注册时为空
+     */
+    std::shared_ptr<ModbusBusWorker> find(const SsModbusMaster &master) const;
+
+    /**
+     * @brief 注销主站的工作线程
+     * @note 已取得工作线程的使用者仍可继续使用，最后一个引用释放时线程退出
+     */
+    void release(const SsModbusMaster &master);
+
+    /**
+     * @brief 注销所有工作线程
+     */
+    void clear();
+
+    /**
+     * @brief 已注册的总线数
+     */
+    size_t size() const;
+
+private:
+    ModbusBusRuntime();
+    ~ModbusBusRuntime();
+
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace modbus
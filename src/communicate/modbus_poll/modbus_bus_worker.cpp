@@ -0,0 +1,222 @@
+/**
+ * @file modbus_bus_worker.cpp
+ * @brief 总线专用I/O工作线程实现
+ */
+
+#include "modbus_bus_worker.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace modbus
+{
+
+class ModbusBusWorker::Impl
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job
+    {
+        ModbusRequest request;
+        Clock::time_point deadline;
+        Completion completion;
+    };
+
+    explicit Impl(std::shared_ptr<SsModbusMaster> master)
+        : master_(std::move(master))
+    {
+        if (!master_)
+        {
+            throw std::invalid_argument("Master must not be null");
+        }
+    }
+
+    void start(const std::shared_ptr<Impl> &self)
+    {
+        // 工作线程持有实现对象，在回调中释放工作线程时由其退出后销毁
+        thread_ = std::thread([self]() { self->run(); });
+    }
+
+    void stop()
+    {
+        std::deque<Job> abandoned;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            abandoned.swap(queue_);
+        }
+        cv_.notify_one();
+
+        // 在完成回调中释放工作线程(或其主站)时不能等待自身，当前请求结束后线程自行退出
+        if (std::this_thread::get_id() == thread_.get_id())
+        {
+            thread_.detach();
+        }
+        else if (thread_.joinable())
+        {
+            thread_.join();
+        }
+
+        auto error = std::make_exception_ptr(std::runtime_error("Bus worker stopped"));
+        for (Job &job : abandoned)
+        {
+            finish(job, ModbusResponse(), error);
+        }
+    }
+
+    void submit(const ModbusRequest &request, std::chrono::milliseconds timeout, Completion completion)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_)
+            {
+                throw std::runtime_error("Bus worker stopped");
+            }
+            queue_.push_back(Job{request, Clock::now() + timeout, std::move(completion)});
+        }
+        cv_.notify_one();
+    }
+
+    SsModbusMaster &master() const
+    {
+        return *master_;
+    }
+
+    size_t pending() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+private:
+    std::shared_ptr<SsModbusMaster> master_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> queue_;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (stopping_)
+                return;
+
+            Job job = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+
+            execute(job);
+
+            lock.lock();
+        }
+    }
+
+    void execute(Job &job)
+    {
+        // 排队期间已超时的请求不再占用总线
+        auto now = Clock::now();
+        if (now >= job.deadline)
+        {
+            finish(job, ModbusResponse(),
+                   std::make_exception_ptr(std::runtime_error("Response timeout")));
+            return;
+        }
+
+        // 只把剩余的时间交给主站，总耗时不超过提交时给定的超时
+        auto remaining = std::max(std::chrono::duration_cast<std::chrono::milliseconds>(job.deadline - now),
+                                  std::chrono::milliseconds(1));
+
+        ModbusResponse response;
+        std::exception_ptr error;
+        try
+        {
+            response = master_->send_request(job.request, remaining);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        finish(job, response, error);
+    }
+
+    static void finish(Job &job, const ModbusResponse &response, std::exception_ptr error)
+    {
+        try
+        {
+            job.completion(response, error);
+        }
+        catch (...)
+        {
+            // 回调异常不能终止工作线程
+        }
+    }
+};
+
+ModbusBusWorker::ModbusBusWorker(std::shared_ptr<SsModbusMaster> master)
+    : impl_(std::make_shared<Impl>(std::move(master)))
+{
+    impl_->start(impl_);
+}
+
+ModbusBusWorker::~ModbusBusWorker()
+{
+    impl_->stop();
+}
+
+std::future<ModbusResponse> ModbusBusWorker::submit(const ModbusRequest &request,
+                                                    std::chrono::milliseconds timeout)
+{
+    auto promise = std::make_shared<std::promise<ModbusResponse>>();
+    std::future<ModbusResponse> future = promise->get_future();
+    impl_->submit(request, timeout, [promise](const ModbusResponse &response, std::exception_ptr error) {
+        if (error)
+        {
+            promise->set_exception(error);
+        }
+        else
+        {
+            promise->set_value(response);
+        }
+    });
+    return future;
+}
+
+void ModbusBusWorker::submit(const ModbusRequest &request, std::chrono::milliseconds timeout,
+                             Completion completion)
+{
+    impl_->submit(request, timeout, std::move(completion));
+}
+
+ModbusResponse ModbusBusWorker::send_request(const ModbusRequest &request,
+                                             std::chrono::milliseconds timeout)
+{
+    return submit(request, timeout).get();
+}
+
+void ModbusBusWorker::send_request_async(const ModbusRequest &request,
+                                         std::chrono::milliseconds timeout,
+                                         ResponseCallback callback)
+{
+    impl_->submit(request, timeout, std::move(callback));
+}
+
+SsModbusMaster &ModbusBusWorker::master() const
+{
+    return impl_->master();
+}
+
+size_t ModbusBusWorker::pending() const
+{
+    return impl_->pending();
+}
+
+} // namespace modbus
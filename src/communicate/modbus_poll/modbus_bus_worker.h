@@ -0,0 +1,99 @@
+/**
+ * @file modbus_bus_worker.h
+ * @brief 总线专用I/O工作线程
+ */
+
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+
+#include "modbus_master.h"
+
+namespace modbus
+{
+
+/**
+ * @brief 总线工作线程
+ * @details 每个工作线程独占一条总线(一个主站)，按提交顺序串行执行请求队列；
+ *          不同总线的工作线程互不等待，单个线程即可让多条串口线同时收发
+ * @note 本身也是一个主站，send_request提交请求并等待结果，
+ *       可直接交给 SsDeviceAdapter 或 ModbusScanScheduler 使用，与其他提交者共享同一队列
+ */
+class ModbusBusWorker : public SsModbusMaster
+{
+public:
+    /**
+     * @brief 请求完成回调
+     * @param response 响应，error非空时无意义
+     * @param error 请求失败时的异常
+     */
+    using Completion = ResponseCallback;
+
+    /**
+     * @brief 构造函数，启动工作线程
+     * @param master 总线主站，工作线程持有其所有权
+     * @throw std::invalid_argument 当master为空
+     */
+    explicit ModbusBusWorker(std::shared_ptr<SsModbusMaster> master);
+
+    /**
+     * @brief 析构函数，等待当前请求完成后退出，队列中尚未执行的请求以异常结束
+     * @note 可在完成回调中析构：此时不等待，工作线程在回调返回后自行退出
+     */
+    ~ModbusBusWorker() override;
+
+    ModbusBusWorker(const ModbusBusWorker &) = delete;
+    ModbusBusWorker &operator=(const ModbusBusWorker &) = delete;
+
+    /**
+     * @brief 提交请求
+     * @param request Modbus请求
+     * @param timeout 超时时间，排队时间计入其中，排队超时的请求不再上总线
+     * @return 响应的future，失败时抛出与直接调用主站相同的异常
+     */
+    std::future<ModbusResponse> submit(const ModbusRequest &request, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 提交请求，完成后在工作线程中调用回调
+     * @param request Modbus请求
+     * @param timeout 超时时间，排队时间计入其中
+     * @param completion 完成回调，不应长时间阻塞
+     */
+    void submit(const ModbusRequest &request, std::chrono::milliseconds timeout, Completion completion);
+
+    /**
+     * @brief 提交请求并等待响应
+     * @throw std::runtime_error 如果请求失败、超时或工作线程已停止
+     */
+    ModbusResponse send_request(const ModbusRequest &request,
+                                std::chrono::milliseconds timeout) override;
+
+    using SsModbusMaster::send_request_async;
+
+    /**
+     * @brief 异步提交请求，等同于带回调的 submit
+     */
+    void send_request_async(const ModbusRequest &request,
+                            std::chrono::milliseconds timeout,
+                            ResponseCallback callback) override;
+
+    /**
+     * @brief 获取总线主站
+     */
+    SsModbusMaster &master() const;
+
+    /**
+     * @brief 队列中等待执行的请求数
+     */
+    size_t pending() const;
+
+private:
+    class Impl;
+    std::shared_ptr<Impl> impl_; // 工作线程也持有，在其自身的回调中析构时由工作线程最后销毁
+};
+
+} // namespace modbus
@@ -0,0 +1,366 @@
+/**
+ * @file modbus_change_notifier.cpp
+ * @brief 寄存器变化订阅(COV)实现
+ */
+
+#include "modbus_change_notifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace modbus
+{
+
+namespace
+{
+
+// 以下比较函数对整个块做归约，不提前退出，便于编译器生成SIMD代码
+
+bool block_changed(const uint16_t *current, const uint16_t *reported, size_t count)
+{
+    uint16_t diff = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        diff |= current[i] ^ reported[i];
+    }
+    return diff != 0;
+}
+
+bool block_exceeds_absolute(const uint16_t *current, const uint16_t *reported, size_t count, int32_t threshold)
+{
+    int32_t hit = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        int32_t delta = static_cast<int32_t>(current[i]) - static_cast<int32_t>(reported[i]);
+        delta = delta < 0 ? -delta : delta;
+        hit |= delta > threshold;
+    }
+    return hit != 0;
+}
+
+bool block_exceeds_percent(const uint16_t *current, const uint16_t *reported, size_t count, float ratio)
+{
+    int32_t hit = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        float now = static_cast<float>(current[i]);
+        float last = static_cast<float>(reported[i]);
+        hit |= std::fabs(now - last) > ratio * last;
+    }
+    return hit != 0;
+}
+
+size_t type_width(TagDataType type)
+{
+    switch (type)
+    {
+    case TagDataType::UINT32:
+    case TagDataType::INT32:
+    case TagDataType::FLOAT32:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+double decode(TagDataType type, const uint16_t *registers)
+{
+    uint32_t word = type_width(type) == 2 ? (static_cast<uint32_t>(registers[0]) << 16) | registers[1]
+                                          : registers[0];
+    switch (type)
+    {
+    case TagDataType::INT16:
+        return static_cast<int16_t>(word);
+    case TagDataType::UINT32:
+        return word;
+    case TagDataType::INT32:
+        return static_cast<int32_t>(word);
+    case TagDataType::FLOAT32:
+    {
+        float f;
+        std::memcpy(&f, &word, sizeof(f));
+        return f;
+    }
+    default:
+        return word;
+    }
+}
+
+} // namespace
+
+class ModbusChangeNotifier::Impl
+{
+public:
+    struct Subscription
+    {
+        SubscriptionId id;
+        SubscriptionSpec spec;
+        size_t count;
+        Callback callback;
+        std::vector<uint16_t> current;  // 最新值
+        std::vector<uint16_t> reported; // 上次通知的值
+        std::vector<uint8_t> seen;      // 首次通知前各寄存器是否已读到
+        size_t unseen;
+        bool has_reported = false;
+    };
+
+    using TableKey = std::pair<uint8_t, RegisterTable>;
+
+    explicit Impl(size_t max_queue)
+        : max_queue_(std::max<size_t>(max_queue, 1))
+    {
+    }
+
+    SubscriptionId subscribe(const SubscriptionSpec &spec, Callback callback)
+    {
+        size_t count = spec.type == TagDataType::RAW ? spec.count : type_width(spec.type);
+        if (count == 0 || static_cast<size_t>(spec.address) + count > 0x10000)
+        {
+            throw std::invalid_argument("Invalid subscription register range");
+        }
+        if (spec.deadband < 0.0)
+        {
+            throw std::invalid_argument("Deadband must not be negative");
+        }
+
+        auto subscription = std::make_shared<Subscription>();
+        subscription->spec = spec;
+        subscription->count = count;
+        subscription->callback = std::move(callback);
+        subscription->current.resize(count);
+        subscription->reported.resize(count);
+        subscription->seen.assign(count, 0);
+        subscription->unseen = count;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        subscription->id = next_id_++;
+        tables_[{spec.slave_address, spec.table}].push_back(subscription);
+        return subscription->id;
+    }
+
+    void unsubscribe(SubscriptionId id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &entry : tables_)
+        {
+            auto &list = entry.second;
+            list.erase(std::remove_if(list.begin(), list.end(),
+                                      [id](const std::shared_ptr<Subscription> &s) { return s->id == id; }),
+                       list.end());
+        }
+    }
+
+    void update(uint8_t slave, RegisterTable table, uint16_t address, const uint16_t *values, size_t count,
+                std::chrono::steady_clock::time_point timestamp)
+    {
+        std::vector<std::pair<Callback, ChangeEvent>> notifications;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = tables_.find({slave, table});
+            if (it == tables_.end())
+                return;
+
+            size_t end = static_cast<size_t>(address) + count;
+            for (auto &subscription : it->second)
+            {
+                Subscription &s = *subscription;
+                size_t first = std::max<size_t>(s.spec.address, address);
+                size_t last = std::min<size_t>(s.spec.address + s.count, end);
+                if (first >= last)
+                    continue;
+
+                std::copy(values + (first - address), values + (last - address),
+                          s.current.begin() + (first - s.spec.address));
+
+                if (!changed(s, first - s.spec.address, last - first))
+                    continue;
+
+                s.reported = s.current;
+                s.has_reported = true;
+
+                ChangeEvent event;
+                event.subscription = s.id;
+                event.spec = s.spec;
+                event.values = s.current;
+                event.value = decode(s.spec.type == TagDataType::RAW ? TagDataType::UINT16 : s.spec.type,
+                                     s.current.data());
+                event.timestamp = timestamp;
+
+                if (s.callback)
+                {
+                    notifications.emplace_back(s.callback, std::move(event));
+                }
+                else
+                {
+                    enqueue(std::move(event));
+                }
+            }
+        }
+
+        cv_.notify_all();
+        for (auto &notification : notifications)
+        {
+            try
+            {
+                notification.first(notification.second);
+            }
+            catch (...)
+            {
+                // 回调异常不能影响其他订阅者和轮询引擎
+            }
+        }
+    }
+
+    bool try_pop(ChangeEvent &event)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pop_locked(event);
+    }
+
+    bool wait_pop(ChangeEvent &event, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, timeout, [this]() { return !queue_.empty(); });
+        return pop_locked(event);
+    }
+
+    size_t queued() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+    uint64_t dropped() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+
+private:
+    size_t max_queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<TableKey, std::vector<std::shared_ptr<Subscription>>> tables_;
+    std::deque<ChangeEvent> queue_;
+    uint64_t dropped_ = 0;
+    SubscriptionId next_id_ = 0;
+
+    // 判断本次更新后是否需要通知，offset/count为本次更新覆盖的订阅内区间
+    static bool changed(Subscription &s, size_t offset, size_t count)
+    {
+        if (!s.has_reported)
+        {
+            for (size_t i = offset; i < offset + count; ++i)
+            {
+                s.unseen -= s.seen[i] ? 0 : 1;
+                s.seen[i] = 1;
+            }
+            return s.unseen == 0;
+        }
+
+        const SubscriptionSpec &spec = s.spec;
+        if (spec.type == TagDataType::RAW)
+        {
+            const uint16_t *current = s.current.data() + offset;
+            const uint16_t *reported = s.reported.data() + offset;
+            switch (spec.deadband_mode)
+            {
+            case DeadbandMode::ABSOLUTE:
+                return block_exceeds_absolute(current, reported, count,
+                                              static_cast<int32_t>(std::min(spec.deadband, 65535.0)));
+            case DeadbandMode::PERCENT:
+                return block_exceeds_percent(current, reported, count, static_cast<float>(spec.deadband / 100.0));
+            default:
+                return block_changed(current, reported, count);
+            }
+        }
+
+        if (!block_changed(s.current.data(), s.reported.data(), s.count))
+            return false;
+
+        double now = decode(spec.type, s.current.data());
+        double last = decode(spec.type, s.reported.data());
+        if (std::isnan(now) || std::isnan(last))
+            return true;
+
+        switch (spec.deadband_mode)
+        {
+        case DeadbandMode::ABSOLUTE:
+            return std::fabs(now - last) > spec.deadband;
+        case DeadbandMode::PERCENT:
+            return std::fabs(now - last) > spec.deadband / 100.0 * std::fabs(last);
+        default:
+            return true;
+        }
+    }
+
+    void enqueue(ChangeEvent event)
+    {
+        if (queue_.size() >= max_queue_)
+        {
+            queue_.pop_front();
+            ++dropped_;
+        }
+        queue_.push_back(std::move(event));
+    }
+
+    bool pop_locked(ChangeEvent &event)
+    {
+        if (queue_.empty())
+            return false;
+        event = std::move(queue_.front());
+        queue_.pop_front();
+        return true;
+    }
+};
+
+ModbusChangeNotifier::ModbusChangeNotifier(size_t max_queue)
+    : impl_(std::make_unique<Impl>(max_queue)) {}
+
+ModbusChangeNotifier::~ModbusChangeNotifier() = default;
+
+ModbusChangeNotifier::SubscriptionId ModbusChangeNotifier::subscribe(const SubscriptionSpec &spec,
+                                                                     Callback callback)
+{
+    return impl_->subscribe(spec, std::move(callback));
+}
+
+void ModbusChangeNotifier::unsubscribe(SubscriptionId id)
+{
+    impl_->unsubscribe(id);
+}
+
+void ModbusChangeNotifier::update(uint8_t slave_address, RegisterTable table, uint16_t address,
+                                  const uint16_t *values, size_t count,
+                                  std::chrono::steady_clock::time_point timestamp)
+{
+    impl_->update(slave_address, table, address, values, count, timestamp);
+}
+
+bool ModbusChangeNotifier::try_pop(ChangeEvent &event)
+{
+    return impl_->try_pop(event);
+}
+
+bool ModbusChangeNotifier::wait_pop(ChangeEvent &event, std::chrono::milliseconds timeout)
+{
+    return impl_->wait_pop(event, timeout);
+}
+
+size_t ModbusChangeNotifier::queued() const
+{
+    return impl_->queued();
+}
+
+uint64_t ModbusChangeNotifier::dropped() const
+{
+    return impl_->dropped();
+}
+
+} // namespace modbus
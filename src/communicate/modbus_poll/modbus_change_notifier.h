@@ -0,0 +1,142 @@
+/**
+ * @file modbus_change_notifier.h
+ * @brief 寄存器变化订阅(COV)
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "modbus_read_planner.h"
+
+namespace modbus
+{
+
+/**
+ * @brief 订阅的数据类型
+ * @note 32位类型占两个连续寄存器，高16位在前，与 SsDeviceAdapter::read_uint32 一致
+ */
+enum class TagDataType : uint8_t
+{
+    RAW,     ///< 原始寄存器区间，死区逐寄存器按无符号数比较
+    UINT16,  ///< 16位无符号整数
+    INT16,   ///< 16位有符号整数
+    UINT32,  ///< 32位无符号整数
+    INT32,   ///< 32位有符号整数
+    FLOAT32  ///< IEEE754单精度浮点数
+};
+
+/**
+ * @brief 死区类型
+ */
+enum class DeadbandMode : uint8_t
+{
+    NONE,     ///< 任何变化都通知
+    ABSOLUTE, ///< 变化量绝对值超过死区时通知
+    PERCENT   ///< 变化量超过上次通知值的百分比时通知
+};
+
+/**
+ * @brief 订阅描述
+ */
+struct SubscriptionSpec
+{
+    uint8_t slave_address;                     ///< 从站地址
+    RegisterTable table;                       ///< 寄存器表
+    uint16_t address;                          ///< 起始地址
+    uint16_t count = 1;                        ///< 寄存器数量，仅RAW类型使用，其余类型由类型决定
+    TagDataType type = TagDataType::RAW;       ///< 数据类型
+    DeadbandMode deadband_mode = DeadbandMode::NONE; ///< 死区类型
+    double deadband = 0.0;                     ///< 死区大小，PERCENT时单位为%
+};
+
+/**
+ * @brief 变化事件
+ */
+struct ChangeEvent
+{
+    size_t subscription;                             ///< 订阅标识
+    SubscriptionSpec spec;                           ///< 订阅描述
+    std::vector<uint16_t> values;                    ///< 当前寄存器值
+    double value = 0.0;                              ///< 按类型解码的值，RAW类型为首个寄存器
+    std::chrono::steady_clock::time_point timestamp; ///< 接收时刻
+};
+
+/**
+ * @brief 变化通知器
+ * @details 轮询引擎把每次读取结果交给update()，通知器把新值与上次通知的值比较，
+ *          超出死区时通过回调或事件队列通知订阅者。订阅区间首次读全时总会通知一次。
+ *          比较以连续寄存器块为单位，循环无分支无提前退出，可由编译器向量化
+ * @note 线程安全；回调在调用update()的线程中、不持锁执行
+ */
+class ModbusChangeNotifier
+{
+public:
+    using SubscriptionId = size_t;
+    using Callback = std::function<void(const ChangeEvent &event)>;
+
+    /**
+     * @brief 构造函数
+     * @param max_queue 事件队列容量，队满时丢弃最旧的事件
+     */
+    explicit ModbusChangeNotifier(size_t max_queue = 4096);
+    ~ModbusChangeNotifier();
+
+    /**
+     * @brief 添加订阅
+     * @param spec 订阅描述
+     * @param callback 回调，为空时事件进入队列
+     * @return 订阅标识
+     * @throw std::invalid_argument 当区间无效或死区为负
+     */
+    SubscriptionId subscribe(const SubscriptionSpec &spec, Callback callback = nullptr);
+
+    /**
+     * @brief 取消订阅，已进入队列的事件保留
+     */
+    void unsubscribe(SubscriptionId id);
+
+    /**
+     * @brief 输入一段读取到的寄存器值
+     * @param slave_address 从站地址
+     * @param table 寄存器表
+     * @param address 起始地址
+     * @param values 寄存器值
+     * @param count 寄存器数量
+     * @param timestamp 接收时刻
+     */
+    void update(uint8_t slave_address, RegisterTable table, uint16_t address,
+                const uint16_t *values, size_t count,
+                std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
+
+    /**
+     * @brief 取出一个事件，不等待
+     * @return 是否取到事件
+     */
+    bool try_pop(ChangeEvent &event);
+
+    /**
+     * @brief 取出一个事件，队列为空时最多等待timeout
+     * @return 是否取到事件
+     */
+    bool wait_pop(ChangeEvent &event, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 队列中的事件数
+     */
+    size_t queued() const;
+
+    /**
+     * @brief 因队满被丢弃的事件数
+     */
+    uint64_t dropped() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace modbus
@@ -0,0 +1,256 @@
+/**
+ * @file modbus_process_image.cpp
+ * @brief 过程映像(寄存器缓存)实现
+ */
+
+#include "modbus_process_image.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace modbus
+{
+
+namespace
+{
+
+constexpr size_t PAGE_SHIFT = 6;
+constexpr size_t PAGE_SIZE = size_t(1) << PAGE_SHIFT;   // 每页寄存器数
+constexpr size_t PAGE_COUNT = 0x10000 >> PAGE_SHIFT;    // 每个寄存器表的页数
+constexpr size_t TABLE_KINDS = 4;                       // 寄存器表种类数
+
+void check_range(uint16_t address, size_t count)
+{
+    if (static_cast<size_t>(address) + count > 0x10000)
+    {
+        throw std::invalid_argument("Register range exceeds address space");
+    }
+}
+
+} // namespace
+
+class ModbusProcessImage::Impl
+{
+public:
+    // 一页寄存器，sequence为奇数表示正在写入
+    struct alignas(64) Page
+    {
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<uint16_t> values[PAGE_SIZE];
+        std::atomic<uint8_t> quality[PAGE_SIZE];
+        std::atomic<int64_t> timestamps[PAGE_SIZE]; // steady_clock纳秒计数
+
+        Page()
+        {
+            for (size_t i = 0; i < PAGE_SIZE; ++i)
+            {
+                values[i].store(0, std::memory_order_relaxed);
+                quality[i].store(static_cast<uint8_t>(DataQuality::NONE), std::memory_order_relaxed);
+                timestamps[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // 一个从站的一个寄存器表，页按需分配且在映像销毁前不释放
+    struct Table
+    {
+        std::atomic<Page *> pages[PAGE_COUNT];
+
+        Table()
+        {
+            for (auto &page : pages)
+            {
+                page.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~Table()
+        {
+            for (auto &page : pages)
+            {
+                delete page.load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    Impl()
+    {
+        for (auto &slave : tables_)
+        {
+            for (auto &table : slave)
+            {
+                table.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ~Impl()
+    {
+        for (auto &slave : tables_)
+        {
+            for (auto &table : slave)
+            {
+                delete table.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void update(uint8_t slave, RegisterTable kind, uint16_t address,
+                const uint16_t *values, size_t count, Clock::time_point timestamp)
+    {
+        check_range(address, count);
+        int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        write_pages(slave, kind, address, count, [&](Page &page, size_t offset, size_t index) {
+            page.values[offset].store(values[index], std::memory_order_relaxed);
+            page.timestamps[offset].store(ns, std::memory_order_relaxed);
+            page.quality[offset].store(static_cast<uint8_t>(DataQuality::GOOD), std::memory_order_relaxed);
+        });
+    }
+
+    void invalidate(uint8_t slave, RegisterTable kind, uint16_t address, size_t count)
+    {
+        check_range(address, count);
+
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        write_pages(slave, kind, address, count, [](Page &page, size_t offset, size_t) {
+            page.quality[offset].store(static_cast<uint8_t>(DataQuality::BAD), std::memory_order_relaxed);
+        });
+    }
+
+    void read(uint8_t slave, RegisterTable kind, uint16_t address, size_t count, RegisterSample *out) const
+    {
+        check_range(address, count);
+
+        const Table *table = tables_[slave][static_cast<size_t>(kind)].load(std::memory_order_acquire);
+        size_t done = 0;
+        while (done < count)
+        {
+            size_t reg = address + done;
+            size_t offset = reg & (PAGE_SIZE - 1);
+            size_t n = std::min(PAGE_SIZE - offset, count - done);
+
+            const Page *page = table ? table->pages[reg >> PAGE_SHIFT].load(std::memory_order_acquire) : nullptr;
+            if (page)
+            {
+                read_page(*page, offset, n, out + done);
+            }
+            else
+            {
+                std::fill(out + done, out + done + n, RegisterSample());
+            }
+            done += n;
+        }
+    }
+
+private:
+    std::atomic<Table *> tables_[256][TABLE_KINDS];
+    std::mutex write_mutex_;
+
+    Page &page_for_write(uint8_t slave, RegisterTable kind, size_t index)
+    {
+        // 仅在持有写锁时调用，新分配的对象以release发布给读取方
+        std::atomic<Table *> &table_slot = tables_[slave][static_cast<size_t>(kind)];
+        Table *table = table_slot.load(std::memory_order_relaxed);
+        if (!table)
+        {
+            table = new Table();
+            table_slot.store(table, std::memory_order_release);
+        }
+
+        std::atomic<Page *> &page_slot = table->pages[index];
+        Page *page = page_slot.load(std::memory_order_relaxed);
+        if (!page)
+        {
+            page = new Page();
+            page_slot.store(page, std::memory_order_release);
+        }
+        return *page;
+    }
+
+    template <typename Writer>
+    void write_pages(uint8_t slave, RegisterTable kind, uint16_t address, size_t count, Writer writer)
+    {
+        size_t done = 0;
+        while (done < count)
+        {
+            size_t reg = address + done;
+            size_t offset = reg & (PAGE_SIZE - 1);
+            size_t n = std::min(PAGE_SIZE - offset, count - done);
+
+            Page &page = page_for_write(slave, kind, reg >> PAGE_SHIFT);
+            uint32_t sequence = page.sequence.load(std::memory_order_relaxed);
+            page.sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                writer(page, offset + i, done + i);
+            }
+
+            page.sequence.store(sequence + 2, std::memory_order_release);
+            done += n;
+        }
+    }
+
+    static void read_page(const Page &page, size_t offset, size_t count, RegisterSample *out)
+    {
+        while (true)
+        {
+            uint32_t before = page.sequence.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                RegisterSample &sample = out[i];
+                sample.value = page.values[offset + i].load(std::memory_order_relaxed);
+                sample.quality = static_cast<DataQuality>(page.quality[offset + i].load(std::memory_order_relaxed));
+                sample.timestamp = Clock::time_point(std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::nanoseconds(page.timestamps[offset + i].load(std::memory_order_relaxed))));
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (page.sequence.load(std::memory_order_relaxed) == before)
+                return;
+        }
+    }
+};
+
+ModbusProcessImage::ModbusProcessImage()
+    : impl_(std::make_unique<Impl>()) {}
+
+ModbusProcessImage::~ModbusProcessImage() = default;
+
+void ModbusProcessImage::update(uint8_t slave_address, RegisterTable table, uint16_t address,
+                                const uint16_t *values, size_t count, Clock::time_point timestamp)
+{
+    impl_->update(slave_address, table, address, values, count, timestamp);
+}
+
+void ModbusProcessImage::invalidate(uint8_t slave_address, RegisterTable table, uint16_t address, size_t count)
+{
+    impl_->invalidate(slave_address, table, address, count);
+}
+
+RegisterSample ModbusProcessImage::read(uint8_t slave_address, RegisterTable table, uint16_t address) const
+{
+    RegisterSample sample;
+    impl_->read(slave_address, table, address, 1, &sample);
+    return sample;
+}
+
+void ModbusProcessImage::read(uint8_t slave_address, RegisterTable table, uint16_t address, size_t count,
+                              RegisterSample *out) const
+{
+    impl_->read(slave_address, table, address, count, out);
+}
+
+} // namespace modbus
@@ -0,0 +1,93 @@
+/**
+ * @file modbus_process_image.h
+ * @brief 过程映像(寄存器缓存)
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "modbus_read_planner.h"
+
+namespace modbus
+{
+
+/**
+ * @brief 数据质量
+ */
+enum class DataQuality : uint8_t
+{
+    NONE = 0, ///< 从未更新
+    GOOD,     ///< 最近一次读取成功
+    BAD       ///< 最近一次读取失败，值与时间戳保留为最后一次成功读取的结果
+};
+
+/**
+ * @brief 单个寄存器的缓存值
+ */
+struct RegisterSample
+{
+    uint16_t value = 0;                              ///< 寄存器值，线圈和离散输入为0或1
+    DataQuality quality = DataQuality::NONE;         ///< 数据质量
+    std::chrono::steady_clock::time_point timestamp; ///< 最后一次成功读取的接收时刻
+};
+
+/**
+ * @brief 过程映像
+ * @details 按 从站 -> 寄存器表 -> 地址 保存每个被轮询寄存器的最新值、接收时间戳和质量标志。
+ *          存储以64个寄存器为一页按需分配，页内由序列锁(seqlock)保护：
+ *          - 写入方(轮询引擎)之间互斥，写入不阻塞读取
+ *          - 读取方不加锁，仅在与写入重叠时重读该页，多个读取线程互不影响
+ * @note 一次读取在同一页内是一致的快照；跨页读取时各页分别一致，可通过时间戳区分
+ */
+class ModbusProcessImage
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    ModbusProcessImage();
+    ~ModbusProcessImage();
+
+    ModbusProcessImage(const ModbusProcessImage &) = delete;
+    ModbusProcessImage &operator=(const ModbusProcessImage &) = delete;
+
+    /**
+     * @brief 写入一段成功读取的寄存器值
+     * @param slave_address 从站地址
+     * @param table 寄存器表
+     * @param address 起始地址
+     * @param values 寄存器值
+     * @param count 寄存器数量
+     * @param timestamp 接收时刻
+     * @throw std::invalid_argument 当区间超出地址空间
+     */
+    void update(uint8_t slave_address, RegisterTable table, uint16_t address,
+                const uint16_t *values, size_t count, Clock::time_point timestamp = Clock::now());
+
+    /**
+     * @brief 将一段寄存器标记为读取失败，保留原有值和时间戳
+     * @throw std::invalid_argument 当区间超出地址空间
+     */
+    void invalidate(uint8_t slave_address, RegisterTable table, uint16_t address, size_t count);
+
+    /**
+     * @brief 读取单个寄存器
+     * @return 缓存值，从未写入时quality为NONE
+     */
+    RegisterSample read(uint8_t slave_address, RegisterTable table, uint16_t address) const;
+
+    /**
+     * @brief 读取一段寄存器
+     * @param out 输出，至少容纳count个元素
+     * @throw std::invalid_argument 当区间超出地址空间
+     */
+    void read(uint8_t slave_address, RegisterTable table, uint16_t address, size_t count,
+              RegisterSample *out) const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace modbus
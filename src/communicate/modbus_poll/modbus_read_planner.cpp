@@ -0,0 +1,273 @@
+/**
+ * @file modbus_read_planner.cpp
+ * @brief 寄存器读取合并规划实现
+ */
+
+#include "modbus_read_planner.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace modbus
+{
+
+namespace
+{
+
+FunctionCode table_function(RegisterTable table)
+{
+    return table == RegisterTable::HOLDING_REGISTERS ? FunctionCode::READ_HOLDING_REGISTERS
+                                                     : FunctionCode::READ_INPUT_REGISTERS;
+}
+
+} // namespace
+
+ModbusReadPlanner::ModbusReadPlanner(const ReadPlanOptions &options)
+    : options_(options)
+{
+    if (options_.max_registers == 0 || options_.max_registers > MAX_READ_REGISTERS)
+    {
+        options_.max_registers = MAX_READ_REGISTERS;
+    }
+}
+
+size_t ModbusReadPlanner::add_tag(const ReadTag &tag)
+{
+    if (tag.table != RegisterTable::HOLDING_REGISTERS && tag.table != RegisterTable::INPUT_REGISTERS)
+    {
+        throw std::invalid_argument("Read planner only supports register tables");
+    }
+    if (tag.count == 0 || tag.count > options_.max_registers)
+    {
+        throw std::invalid_argument("Tag register count must be 1-" + std::to_string(options_.max_registers));
+    }
+    if (static_cast<uint32_t>(tag.address) + tag.count > 0x10000)
+    {
+        throw std::invalid_argument("Tag exceeds register address space");
+    }
+
+    tags_.push_back(tag);
+    values_.emplace_back();
+    dirty_ = true;
+    return tags_.size() - 1;
+}
+
+void ModbusReadPlanner::clear()
+{
+    tags_.clear();
+    values_.clear();
+    plan_.clear();
+    dirty_ = false;
+}
+
+const std::vector<PlannedRead> &ModbusReadPlanner::plan()
+{
+    if (dirty_)
+    {
+        build_plan();
+        dirty_ = false;
+    }
+    return plan_;
+}
+
+void ModbusReadPlanner::build_plan()
+{
+    plan_.clear();
+
+    // 按 从站 -> 寄存器表 -> 地址 排序
+    std::vector<size_t> order(tags_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        const ReadTag &ta = tags_[a];
+        const ReadTag &tb = tags_[b];
+        return std::tie(ta.slave_address, ta.table, ta.address) <
+               std::tie(tb.slave_address, tb.table, tb.address);
+    });
+
+    if (options_.cost_model)
+    {
+        // 同一从站同一寄存器表的标签各自独立规划
+        std::vector<size_t> block;
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            block.push_back(order[i]);
+            bool last = i + 1 == order.size() ||
+                        tags_[order[i + 1]].slave_address != tags_[order[i]].slave_address ||
+                        tags_[order[i + 1]].table != tags_[order[i]].table;
+            if (last)
+            {
+                build_block_by_cost(block);
+                block.clear();
+            }
+        }
+        return;
+    }
+
+    // 从左到右贪心合并，在单请求长度和间隙约束下得到的请求数最少
+    uint32_t start = 0;
+    uint32_t end = 0;
+    for (size_t index : order)
+    {
+        const ReadTag &tag = tags_[index];
+        uint32_t tag_end = static_cast<uint32_t>(tag.address) + tag.count;
+
+        if (!plan_.empty())
+        {
+            const ModbusRequest &current = plan_.back().request;
+            bool same_block = current.slave_address == tag.slave_address &&
+                              current.function_code == table_function(tag.table);
+            uint32_t merged_end = std::max(end, tag_end);
+
+            if (same_block &&
+                tag.address <= end + options_.max_gap &&
+                merged_end - start <= options_.max_registers)
+            {
+                end = merged_end;
+                plan_.back().request.register_count = static_cast<uint16_t>(end - start);
+                plan_.back().tag_indices.push_back(index);
+                continue;
+            }
+        }
+
+        // 开始新的请求
+        start = tag.address;
+        end = tag_end;
+
+        PlannedRead read;
+        read.request.slave_address = tag.slave_address;
+        read.request.function_code = table_function(tag.table);
+        read.request.start_address = tag.address;
+        read.request.register_count = tag.count;
+        read.tag_indices.push_back(index);
+        plan_.push_back(std::move(read));
+    }
+}
+
+void ModbusReadPlanner::build_block_by_cost(const std::vector<size_t> &block)
+{
+    // 按地址有序的标签划分为若干连续段，每段合并为一个请求；
+    // 动态规划求估算总线时间之和最小的划分，跨越间隙与否由模型决定
+    const size_t n = block.size();
+    std::vector<double> best(n + 1, 0.0);
+    std::vector<size_t> split(n + 1, 0);
+
+    for (size_t j = 0; j < n; ++j)
+    {
+        best[j + 1] = -1.0;
+        uint32_t end = 0;
+        // 段起点左移时区间只会变长，超出单请求上限后即可停止
+        for (size_t i = j + 1; i-- > 0;)
+        {
+            const ReadTag &tag = tags_[block[i]];
+            end = std::max(end, static_cast<uint32_t>(tag.address) + tag.count);
+            uint32_t span = end - tag.address;
+            if (span > options_.max_registers)
+                break;
+
+            double cost = best[i] + options_.cost_model->estimate_us(8, 5 + span * 2);
+            // 估算相同时选择更长的段，减少请求数
+            if (best[j + 1] < 0.0 || cost <= best[j + 1])
+            {
+                best[j + 1] = cost;
+                split[j + 1] = i;
+            }
+        }
+    }
+
+    std::vector<std::pair<size_t, size_t>> segments;
+    for (size_t j = n; j > 0; j = split[j])
+    {
+        segments.emplace_back(split[j], j);
+    }
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it)
+    {
+        push_read(block, it->first, it->second);
+    }
+}
+
+void ModbusReadPlanner::push_read(const std::vector<size_t> &block, size_t first, size_t last)
+{
+    const ReadTag &head = tags_[block[first]];
+
+    PlannedRead read;
+    read.request.slave_address = head.slave_address;
+    read.request.function_code = table_function(head.table);
+    read.request.start_address = head.address;
+
+    uint32_t end = 0;
+    for (size_t i = first; i < last; ++i)
+    {
+        const ReadTag &tag = tags_[block[i]];
+        end = std::max(end, static_cast<uint32_t>(tag.address) + tag.count);
+        read.tag_indices.push_back(block[i]);
+    }
+    read.request.register_count = static_cast<uint16_t>(end - head.address);
+    plan_.push_back(std::move(read));
+}
+
+size_t ModbusReadPlanner::execute(SsModbusMaster &master, std::chrono::milliseconds timeout)
+{
+    size_t succeeded = 0;
+    for (const PlannedRead &read : plan())
+    {
+        if (execute_read(master, read, timeout))
+        {
+            ++succeeded;
+        }
+    }
+    return succeeded;
+}
+
+bool ModbusReadPlanner::execute_read(SsModbusMaster &master, const PlannedRead &read,
+                                     std::chrono::milliseconds timeout)
+{
+    try
+    {
+        auto begin = std::chrono::steady_clock::now();
+        ModbusResponse response = master.send_request(read.request, timeout);
+        if (options_.cost_model && response.error == ModbusError::NO_ERROR)
+        {
+            options_.cost_model->record(read.request, std::chrono::duration_cast<std::chrono::microseconds>(
+                                                          std::chrono::steady_clock::now() - begin));
+        }
+        scatter(read, &response);
+        return response.error == ModbusError::NO_ERROR;
+    }
+    catch (const std::exception &)
+    {
+        scatter(read, nullptr);
+        return false;
+    }
+}
+
+void ModbusReadPlanner::scatter(const PlannedRead &read, const ModbusResponse *response)
+{
+    bool ok = response != nullptr &&
+              response->error == ModbusError::NO_ERROR &&
+              response->data.size() == read.request.register_count * 2u;
+
+    for (size_t index : read.tag_indices)
+    {
+        const ReadTag &tag = tags_[index];
+        TagValue &value = values_[index];
+
+        value.valid = ok;
+        value.error = response ? response->error : ModbusError::NO_ERROR;
+        if (!ok)
+            continue;
+
+        // 按标签在合并区间内的偏移取出对应寄存器
+        size_t offset = (tag.address - read.request.start_address) * 2;
+        value.values.resize(tag.count);
+        for (uint16_t i = 0; i < tag.count; ++i)
+        {
+            const uint8_t *p = response->data.data() + offset + i * 2;
+            value.values[i] = (p[0] << 8) | p[1];
+        }
+    }
+}
+
+} // namespace modbus
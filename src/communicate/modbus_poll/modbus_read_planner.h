@@ -0,0 +1,147 @@
+/**
+ * @file modbus_read_planner.h
+ * @brief 寄存器读取合并规划
+ */
+
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include "modbus_master.h"
+#include "modbus_bus_cost_model.h"
+
+namespace modbus
+{
+
+/**
+ * @brief 寄存器表
+ */
+enum class RegisterTable : uint8_t
+{
+    HOLDING_REGISTERS, ///< 保持寄存器(FC03)
+    INPUT_REGISTERS,   ///< 输入寄存器(FC04)
+    COILS,             ///< 线圈(FC01)，读取规划暂不支持
+    DISCRETE_INPUTS    ///< 离散输入(FC02)，读取规划暂不支持
+};
+
+/**
+ * @brief 读取标签，描述一个需要读取的寄存器区间
+ */
+struct ReadTag
+{
+    uint8_t slave_address;  ///< 从站地址
+    RegisterTable table;    ///< 寄存器表
+    uint16_t address;       ///< 起始地址
+    uint16_t count;         ///< 寄存器数量(1-125)
+};
+
+/**
+ * @brief 标签读取结果
+ */
+struct TagValue
+{
+    std::vector<uint16_t> values;              ///< 寄存器值
+    ModbusError error = ModbusError::NO_ERROR; ///< Modbus异常码
+    bool valid = false;                        ///< 是否读取成功
+};
+
+/**
+ * @brief 规划选项
+ */
+struct ReadPlanOptions
+{
+    uint16_t max_registers = MAX_READ_REGISTERS; ///< 单个请求最多读取的寄存器数
+    uint16_t max_gap = 0;                        ///< 允许合并跨越的未使用寄存器数
+
+    /**
+     * @brief 总线占用时间模型，非空时按估算总线时间最小化规划并忽略max_gap
+     * @note 执行时以实测往返时间校准该模型，其生命周期须覆盖规划器的使用
+     */
+    ModbusBusCostModel *cost_model = nullptr;
+};
+
+/**
+ * @brief 合并后的读取请求
+ */
+struct PlannedRead
+{
+    ModbusRequest request;           ///< 读取请求
+    std::vector<size_t> tag_indices; ///< 该请求覆盖的标签序号
+};
+
+/**
+ * @brief 读取合并规划器
+ * @details 将同一从站同一寄存器表中相邻或重叠的标签合并为尽量少的FC03/FC04请求，
+ *          执行后再把读取结果按标签拆分
+ * @note 跨越间隙时会读取间隙中的寄存器，max_gap或cost_model只应在间隙寄存器可读的设备上启用
+ */
+class ModbusReadPlanner
+{
+public:
+    explicit ModbusReadPlanner(const ReadPlanOptions &options = ReadPlanOptions());
+
+    /**
+     * @brief 添加读取标签
+     * @param tag 标签
+     * @return 标签序号，用于获取结果
+     * @throw std::invalid_argument 当寄存器数量为0或超过单个请求上限，或标签属于位表
+     */
+    size_t add_tag(const ReadTag &tag);
+
+    /**
+     * @brief 清空所有标签
+     */
+    void clear();
+
+    /**
+     * @brief 获取规划结果，标签变化后首次调用时重新规划
+     */
+    const std::vector<PlannedRead> &plan();
+
+    /**
+     * @brief 依次执行所有合并请求并拆分结果
+     * @param master Modbus主站
+     * @param timeout 单个请求的超时时间
+     * @return 成功的请求数
+     * @note 某个请求失败不影响其余请求，其覆盖的标签标记为无效
+     */
+    size_t execute(SsModbusMaster &master, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 执行单个合并请求并拆分结果
+     * @param master Modbus主站
+     * @param read 合并请求，须来自plan()
+     * @param timeout 超时时间
+     * @return 请求是否成功
+     */
+    bool execute_read(SsModbusMaster &master, const PlannedRead &read, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 将一个合并请求的响应拆分到其覆盖的标签
+     * @param read 合并请求
+     * @param response 响应，为空指针表示请求失败
+     */
+    void scatter(const PlannedRead &read, const ModbusResponse *response);
+
+    /**
+     * @brief 获取标签读取结果
+     * @param index 标签序号
+     */
+    const TagValue &value(size_t index) const { return values_.at(index); }
+
+    const std::vector<ReadTag> &tags() const { return tags_; }
+
+private:
+    void build_plan();
+    void build_block_by_cost(const std::vector<size_t> &block);
+    void push_read(const std::vector<size_t> &block, size_t first, size_t last);
+
+    ReadPlanOptions options_;
+    std::vector<ReadTag> tags_;
+    std::vector<TagValue> values_;
+    std::vector<PlannedRead> plan_;
+    bool dirty_ = false;
+};
+
+} // namespace modbus
@@ -0,0 +1,482 @@
+/**
+ * @file modbus_scan_scheduler.cpp
+ * @brief 周期扫描调度器实现
+ */
+
+#include "modbus_scan_scheduler.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace modbus
+{
+
+class ModbusScanScheduler::Impl
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Group
+    {
+        GroupId id;
+        std::chrono::milliseconds period;
+        std::chrono::milliseconds timeout;
+        ModbusReadPlanner planner;
+        ScanCallback callback;
+
+        // 当前作业状态
+        Clock::time_point release;  // 本次释放时刻
+        Clock::time_point deadline; // 本次截止时刻
+        bool active = false;        // 已释放且未完成
+        bool started = false;       // 已发出首个请求
+        size_t next_read = 0;       // 下一个待执行的合并请求
+
+        ScanGroupStats stats;
+        std::vector<TagValue> snapshot; // 最近一次完成扫描的结果
+        std::chrono::microseconds jitter_total{0};
+
+        Group(GroupId id_, std::chrono::milliseconds period_, std::chrono::milliseconds timeout_,
+              const ReadPlanOptions &options, ScanCallback callback_)
+            : id(id_), period(period_), timeout(timeout_), planner(options), callback(std::move(callback_))
+        {
+        }
+    };
+
+    struct Bus
+    {
+        std::shared_ptr<SsModbusMaster> master;
+        ReadPlanOptions options;
+        std::vector<std::unique_ptr<Group>> groups;
+        std::shared_ptr<ModbusProcessImage> image;
+        std::shared_ptr<ModbusChangeNotifier> notifier;
+        mutable std::mutex mutex;
+        std::condition_variable cv;
+        std::thread thread;
+    };
+
+    ~Impl()
+    {
+        stop();
+    }
+
+    BusId add_bus(std::shared_ptr<SsModbusMaster> master, const ReadPlanOptions &options)
+    {
+        if (!master)
+        {
+            throw std::invalid_argument("Master must not be null");
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto bus = std::make_unique<Bus>();
+        bus->master = std::move(master);
+        bus->options = options;
+        bus->image = image_;
+        bus->notifier = notifier_;
+        buses_.push_back(std::move(bus));
+        if (running_)
+        {
+            launch(*buses_.back());
+        }
+        return buses_.size() - 1;
+    }
+
+    GroupId add_group(BusId bus_id, std::chrono::milliseconds period, const std::vector<ReadTag> &tags,
+                      std::chrono::milliseconds timeout, ScanCallback callback)
+    {
+        if (period.count() <= 0)
+        {
+            throw std::invalid_argument("Scan period must be positive");
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        Bus &bus = bus_at(bus_id);
+
+        // 在加入总线前完成标签校验与规划，扫描线程只看到完整的扫描组
+        auto group = std::make_unique<Group>(groups_.size(), period, timeout, bus.options, std::move(callback));
+        for (const ReadTag &tag : tags)
+        {
+            group->planner.add_tag(tag);
+        }
+        group->planner.plan();
+        group->snapshot.resize(tags.size());
+
+        Group *raw = group.get();
+        {
+            std::lock_guard<std::mutex> bus_lock(bus.mutex);
+            group->release = Clock::now();
+            bus.groups.push_back(std::move(group));
+        }
+        bus.cv.notify_one();
+
+        groups_.push_back({&bus, raw});
+        return raw->id;
+    }
+
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_)
+            return;
+
+        running_ = true;
+        Clock::time_point now = Clock::now();
+        for (auto &bus : buses_)
+        {
+            {
+                std::lock_guard<std::mutex> bus_lock(bus->mutex);
+                for (auto &group : bus->groups)
+                {
+                    group->release = now;
+                    group->active = false;
+                }
+            }
+            launch(*bus);
+        }
+    }
+
+    void stop()
+    {
+        // 在锁外等待线程退出，回调中查询统计或结果不会死锁
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_)
+                return;
+
+            running_ = false;
+            for (auto &bus : buses_)
+            {
+                {
+                    // 持锁通知，避免扫描线程在检查running_与等待之间错过唤醒
+                    std::lock_guard<std::mutex> bus_lock(bus->mutex);
+                }
+                bus->cv.notify_all();
+                threads.push_back(std::move(bus->thread));
+            }
+        }
+
+        for (auto &thread : threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+    }
+
+    bool running() const
+    {
+        return running_;
+    }
+
+    void set_process_image(std::shared_ptr<ModbusProcessImage> image)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        image_ = image;
+        for (auto &bus : buses_)
+        {
+            std::lock_guard<std::mutex> bus_lock(bus->mutex);
+            bus->image = image;
+        }
+    }
+
+    void set_change_notifier(std::shared_ptr<ModbusChangeNotifier> notifier)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        notifier_ = notifier;
+        for (auto &bus : buses_)
+        {
+            std::lock_guard<std::mutex> bus_lock(bus->mutex);
+            bus->notifier = notifier;
+        }
+    }
+
+    ScanGroupStats stats(GroupId id) const
+    {
+        Bus *bus;
+        Group *group;
+        locate(id, bus, group);
+        std::lock_guard<std::mutex> lock(bus->mutex);
+        return group->stats;
+    }
+
+    TagValue value(GroupId id, size_t tag) const
+    {
+        Bus *bus;
+        Group *group;
+        locate(id, bus, group);
+        std::lock_guard<std::mutex> lock(bus->mutex);
+        return group->snapshot.at(tag);
+    }
+
+    SsModbusMaster &master(BusId bus_id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return *bus_at(bus_id).master;
+    }
+
+private:
+    mutable std::mutex mutex_; // 保护buses_与groups_
+    std::vector<std::unique_ptr<Bus>> buses_;
+    std::vector<std::pair<Bus *, Group *>> groups_;
+    std::shared_ptr<ModbusProcessImage> image_;
+    std::shared_ptr<ModbusChangeNotifier> notifier_;
+    std::atomic<bool> running_{false};
+
+    Bus &bus_at(BusId id)
+    {
+        if (id >= buses_.size())
+        {
+            throw std::invalid_argument("Unknown bus");
+        }
+        return *buses_[id];
+    }
+
+    void locate(GroupId id, Bus *&bus, Group *&group) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (id >= groups_.size())
+        {
+            throw std::invalid_argument("Unknown scan group");
+        }
+        bus = groups_[id].first;
+        group = groups_[id].second;
+    }
+
+    void launch(Bus &bus)
+    {
+        bus.thread = std::thread([this, &bus]() { run(bus); });
+    }
+
+    // 总线扫描线程
+    void run(Bus &bus)
+    {
+        std::unique_lock<std::mutex> lock(bus.mutex);
+        while (running_)
+        {
+            Clock::time_point now = Clock::now();
+            Group *pick = nullptr;
+            Clock::time_point wakeup = Clock::time_point::max();
+
+            // 释放到期的作业，并在就绪作业中选出截止时间最早的
+            for (auto &group : bus.groups)
+            {
+                if (!group->active && group->release <= now)
+                {
+                    group->active = true;
+                    group->started = false;
+                    group->next_read = 0;
+                    group->deadline = group->release + group->period;
+                }
+
+                if (group->active)
+                {
+                    if (!pick || group->deadline < pick->deadline)
+                    {
+                        pick = group.get();
+                    }
+                }
+                else if (group->release < wakeup)
+                {
+                    wakeup = group->release;
+                }
+            }
+
+            if (!pick)
+            {
+                if (wakeup == Clock::time_point::max())
+                {
+                    bus.cv.wait(lock);
+                }
+                else
+                {
+                    bus.cv.wait_until(lock, wakeup);
+                }
+                continue;
+            }
+
+            if (!pick->started)
+            {
+                pick->started = true;
+                record_jitter(*pick, now);
+            }
+
+            // 规划在加入总线前已完成，之后只有本线程访问planner，请求期间不持锁
+            const std::vector<PlannedRead> &plan = pick->planner.plan();
+            if (pick->next_read < plan.size())
+            {
+                const PlannedRead &read = plan[pick->next_read++];
+                std::shared_ptr<ModbusProcessImage> image = bus.image;
+                std::shared_ptr<ModbusChangeNotifier> notifier = bus.notifier;
+                lock.unlock();
+                bool ok = pick->planner.execute_read(*bus.master, read, pick->timeout);
+                publish(image.get(), notifier.get(), pick->planner, read);
+                lock.lock();
+                if (!ok)
+                {
+                    ++pick->stats.failed_reads;
+                }
+            }
+
+            if (pick->next_read >= plan.size())
+            {
+                complete(*pick, Clock::now());
+                if (pick->callback)
+                {
+                    // snapshot只由本线程修改，回调期间不持锁
+                    lock.unlock();
+                    try
+                    {
+                        pick->callback(pick->id, pick->snapshot);
+                    }
+                    catch (...)
+                    {
+                        // 回调异常不能终止扫描线程
+                    }
+                    lock.lock();
+                }
+            }
+        }
+    }
+
+    // 将一个合并请求覆盖的标签写入过程映像和变化通知器
+    static void publish(ModbusProcessImage *image, ModbusChangeNotifier *notifier,
+                        const ModbusReadPlanner &planner, const PlannedRead &read)
+    {
+        if (!image && !notifier)
+            return;
+
+        Clock::time_point now = Clock::now();
+        for (size_t index : read.tag_indices)
+        {
+            const ReadTag &tag = planner.tags()[index];
+            const TagValue &value = planner.value(index);
+            if (!value.valid)
+            {
+                if (image)
+                {
+                    image->invalidate(tag.slave_address, tag.table, tag.address, tag.count);
+                }
+                continue;
+            }
+
+            if (image)
+            {
+                image->update(tag.slave_address, tag.table, tag.address, value.values.data(), tag.count, now);
+            }
+            if (notifier)
+            {
+                notifier->update(tag.slave_address, tag.table, tag.address, value.values.data(), tag.count, now);
+            }
+        }
+    }
+
+    void record_jitter(Group &group, Clock::time_point now)
+    {
+        auto jitter = std::chrono::duration_cast<std::chrono::microseconds>(now - group.release);
+        ScanGroupStats &stats = group.stats;
+        stats.last_jitter = jitter;
+        if (jitter > stats.max_jitter)
+        {
+            stats.max_jitter = jitter;
+        }
+        group.jitter_total += jitter;
+        stats.mean_jitter = group.jitter_total / (stats.scans + 1);
+    }
+
+    void complete(Group &group, Clock::time_point done)
+    {
+        ScanGroupStats &stats = group.stats;
+        ++stats.scans;
+
+        auto response = std::chrono::duration_cast<std::chrono::microseconds>(done - group.release);
+        stats.last_response = response;
+        if (response > stats.max_response)
+        {
+            stats.max_response = response;
+        }
+        if (done > group.deadline)
+        {
+            ++stats.overruns;
+        }
+
+        for (size_t i = 0; i < group.snapshot.size(); ++i)
+        {
+            group.snapshot[i] = group.planner.value(i);
+        }
+
+        // 释放时刻沿固定网格推进；已整体错过的周期跳过，最多补一次迟到的扫描
+        group.active = false;
+        group.release += group.period;
+        if (done > group.release)
+        {
+            auto missed = (done - group.release) / group.period;
+            group.release += missed * group.period;
+            stats.skipped += static_cast<uint64_t>(missed);
+        }
+    }
+};
+
+ModbusScanScheduler::ModbusScanScheduler()
+    : impl_(std::make_unique<Impl>()) {}
+
+ModbusScanScheduler::~ModbusScanScheduler() = default;
+
+ModbusScanScheduler::BusId ModbusScanScheduler::add_bus(std::shared_ptr<SsModbusMaster> master,
+                                                        const ReadPlanOptions &options)
+{
+    return impl_->add_bus(std::move(master), options);
+}
+
+ModbusScanScheduler::GroupId ModbusScanScheduler::add_group(BusId bus, std::chrono::milliseconds period,
+                                                            const std::vector<ReadTag> &tags,
+                                                            std::chrono::milliseconds timeout,
+                                                            ScanCallback callback)
+{
+    return impl_->add_group(bus, period, tags, timeout, std::move(callback));
+}
+
+void ModbusScanScheduler::start()
+{
+    impl_->start();
+}
+
+void ModbusScanScheduler::stop()
+{
+    impl_->stop();
+}
+
+bool ModbusScanScheduler::running() const
+{
+    return impl_->running();
+}
+
+void ModbusScanScheduler::set_process_image(std::shared_ptr<ModbusProcessImage> image)
+{
+    impl_->set_process_image(std::move(image));
+}
+
+void ModbusScanScheduler::set_change_notifier(std::shared_ptr<ModbusChangeNotifier> notifier)
+{
+    impl_->set_change_notifier(std::move(notifier));
+}
+
+ScanGroupStats ModbusScanScheduler::stats(GroupId group) const
+{
+    return impl_->stats(group);
+}
+
+TagValue ModbusScanScheduler::value(GroupId group, size_t tag) const
+{
+    return impl_->value(group, tag);
+}
+
+SsModbusMaster &ModbusScanScheduler::master(BusId bus) const
+{
+    return impl_->master(bus);
+}
+
+} // namespace modbus
@@ -0,0 +1,137 @@
+/**
+ * @file modbus_scan_scheduler.h
+ * @brief 周期扫描调度器
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "modbus_read_planner.h"
+#include "modbus_process_image.h"
+#include "modbus_change_notifier.h"
+
+namespace modbus
+{
+
+/**
+ * @brief 扫描组统计
+ * @details 抖动为实际开始扫描时刻相对释放时刻的延迟，响应时间为释放到扫描完成的时间
+ */
+struct ScanGroupStats
+{
+    uint64_t scans = 0;                          ///< 完成的扫描次数
+    uint64_t overruns = 0;                       ///< 超过截止时间(下一周期起点)才完成的次数
+    uint64_t skipped = 0;                        ///< 因总线过载而跳过的周期数
+    uint64_t failed_reads = 0;                   ///< 失败的读取请求数
+    std::chrono::microseconds last_jitter{0};    ///< 最近一次抖动
+    std::chrono::microseconds max_jitter{0};     ///< 最大抖动
+    std::chrono::microseconds mean_jitter{0};    ///< 平均抖动
+    std::chrono::microseconds last_response{0};  ///< 最近一次响应时间
+    std::chrono::microseconds max_response{0};   ///< 最大响应时间
+};
+
+/**
+ * @brief 周期扫描调度器
+ * @details 每条总线(一个主站)一个扫描线程，总线上的扫描组按最早截止时间优先(EDF)调度：
+ *          - 第k次释放时刻固定为 起始时刻 + k × 周期，不随执行时间累积漂移
+ *          - 截止时间为下一次释放时刻，调度粒度为单个合并请求，短周期组可插入长周期组的扫描
+ *          - 总线过载时未完成的扫描继续执行并计为超限，已整体错过的周期直接跳过，
+ *            各组按比例降低实际刷新率而不是积压请求
+ * @note 线程安全；扫描组回调在总线线程中执行，不应长时间阻塞
+ */
+class ModbusScanScheduler
+{
+public:
+    using BusId = size_t;
+    using GroupId = size_t;
+
+    /**
+     * @brief 扫描完成回调
+     * @param group 扫描组
+     * @param values 组内各标签的本次结果，顺序与添加时的标签一致
+     */
+    using ScanCallback = std::function<void(GroupId group, const std::vector<TagValue> &values)>;
+
+    ModbusScanScheduler();
+    ~ModbusScanScheduler();
+
+    ModbusScanScheduler(const ModbusScanScheduler &) = delete;
+    ModbusScanScheduler &operator=(const ModbusScanScheduler &) = delete;
+
+    /**
+     * @brief 添加总线
+     * @param master 该总线的主站，调度器持有其所有权；
+     *               传入 ModbusBusRuntime 提供的工作线程时与其他模块共享该总线的请求队列
+     * @param options 该总线上扫描组的合并规划选项
+     * @return 总线标识
+     * @throw std::invalid_argument 当master为空
+     */
+    BusId add_bus(std::shared_ptr<SsModbusMaster> master, const ReadPlanOptions &options = ReadPlanOptions());
+
+    /**
+     * @brief 添加扫描组
+     * @param bus 所属总线
+     * @param period 扫描周期
+     * @param tags 组内标签
+     * @param timeout 单个请求的超时时间
+     * @param callback 每次扫描完成后的回调，可为空
+     * @return 扫描组标识
+     * @throw std::invalid_argument 当总线不存在、周期非正或标签无效
+     * @note 运行中添加的扫描组立即开始首次扫描
+     */
+    GroupId add_group(BusId bus, std::chrono::milliseconds period, const std::vector<ReadTag> &tags,
+                      std::chrono::milliseconds timeout = std::chrono::milliseconds(1000),
+                      ScanCallback callback = nullptr);
+
+    /**
+     * @brief 启动所有总线的扫描线程
+     */
+    void start();
+
+    /**
+     * @brief 停止扫描并等待线程退出，正在进行的请求完成后返回
+     * @note 不能在扫描组回调中调用
+     */
+    void stop();
+
+    bool running() const;
+
+    /**
+     * @brief 设置过程映像，每个读取请求完成后即写入其覆盖的标签，失败的标签标记为BAD
+     * @param image 过程映像，为空时停止写入
+     */
+    void set_process_image(std::shared_ptr<ModbusProcessImage> image);
+
+    /**
+     * @brief 设置变化通知器，每个读取请求成功后即输入其覆盖的标签
+     * @param notifier 变化通知器，为空时停止输入
+     */
+    void set_change_notifier(std::shared_ptr<ModbusChangeNotifier> notifier);
+
+    /**
+     * @brief 获取扫描组统计
+     */
+    ScanGroupStats stats(GroupId group) const;
+
+    /**
+     * @brief 获取扫描组最近一次完成扫描的结果
+     * @param group 扫描组
+     * @param tag 组内标签序号
+     */
+    TagValue value(GroupId group, size_t tag) const;
+
+    /**
+     * @brief 获取总线的主站
+     */
+    SsModbusMaster &master(BusId bus) const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace modbus
@@ -0,0 +1,240 @@
+/**
+ * @file modbus_write_batcher.cpp
+ * @brief 寄存器写入合并实现
+ */
+
+#include "modbus_write_batcher.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace modbus
+{
+
+class ModbusWriteBatcher::Impl
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 一段连续寄存器写入，对应一个请求
+    struct Run
+    {
+        uint8_t slave_address;
+        uint16_t start_address;
+        RegisterValues values;
+        std::vector<std::promise<void>> promises;
+    };
+
+    Impl(SsModbusMaster &master, const WriteBatchOptions &options)
+        : master_(master), options_(options)
+    {
+        if (options_.max_registers == 0 || options_.max_registers > MAX_WRITE_REGISTERS)
+        {
+            options_.max_registers = MAX_WRITE_REGISTERS;
+        }
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~Impl()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+        send_pending();
+    }
+
+    std::future<void> submit(uint8_t slave, uint16_t address, const uint16_t *values, size_t count)
+    {
+        if (count == 0 || count > options_.max_registers)
+        {
+            throw std::invalid_argument("Values count must be 1-" + std::to_string(options_.max_registers));
+        }
+        if (static_cast<uint32_t>(address) + count > 0x10000)
+        {
+            throw std::invalid_argument("Write exceeds register address space");
+        }
+
+        std::promise<void> promise;
+        std::future<void> future = promise.get_future();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!queue_.empty())
+        {
+            // 只在最后一段的末尾追加，不改变与其他写入的先后顺序
+            Run &last = queue_.back();
+            if (last.slave_address == slave &&
+                static_cast<uint32_t>(last.start_address) + last.values.size() == address &&
+                last.values.size() + count <= options_.max_registers)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    last.values.push_back(values[i]);
+                }
+                last.promises.push_back(std::move(promise));
+                return future;
+            }
+        }
+
+        Run run;
+        run.slave_address = slave;
+        run.start_address = address;
+        run.values.assign(values, values + count);
+        run.promises.push_back(std::move(promise));
+
+        bool first = queue_.empty();
+        queue_.push_back(std::move(run));
+        if (first)
+        {
+            deadline_ = Clock::now() + options_.window;
+            cv_.notify_one();
+        }
+        return future;
+    }
+
+    void send_pending()
+    {
+        // 发送锁保证先取出的批次先发送
+        std::lock_guard<std::mutex> send_lock(send_mutex_);
+        std::deque<Run> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batch.swap(queue_);
+        }
+
+        std::map<uint8_t, std::exception_ptr> failures;
+        for (Run &run : batch)
+        {
+            auto failed = failures.find(run.slave_address);
+            if (failed != failures.end())
+            {
+                complete(run, failed->second);
+                continue;
+            }
+
+            try
+            {
+                send(run);
+                complete(run, nullptr);
+            }
+            catch (...)
+            {
+                std::exception_ptr error = std::current_exception();
+                failures[run.slave_address] = error;
+                complete(run, error);
+            }
+        }
+    }
+
+    size_t pending() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+private:
+    SsModbusMaster &master_;
+    WriteBatchOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Run> queue_;
+    Clock::time_point deadline_;
+    bool stopping_ = false;
+
+    std::mutex send_mutex_;
+    std::thread thread_;
+
+    // 窗口计时线程
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (stopping_)
+                return;
+
+            // 等待窗口结束，期间队列可能已被flush()取走
+            cv_.wait_until(lock, deadline_, [this]() { return stopping_ || queue_.empty(); });
+            if (stopping_)
+                return;
+            if (queue_.empty())
+                continue;
+
+            lock.unlock();
+            send_pending();
+            lock.lock();
+        }
+    }
+
+    void send(const Run &run)
+    {
+        ModbusRequest request;
+        request.slave_address = run.slave_address;
+        request.start_address = run.start_address;
+        request.register_count = static_cast<uint16_t>(run.values.size());
+        request.values = run.values;
+        request.function_code = run.values.size() == 1 ? FunctionCode::WRITE_SINGLE_REGISTER
+                                                        : FunctionCode::WRITE_MULTIPLE_REGISTERS;
+
+        ModbusResponse response = master_.send_request(request, options_.timeout);
+        if (response.error != ModbusError::NO_ERROR)
+        {
+            throw ModbusException(response.error);
+        }
+    }
+
+    static void complete(Run &run, std::exception_ptr error)
+    {
+        for (auto &promise : run.promises)
+        {
+            if (error)
+            {
+                promise.set_exception(error);
+            }
+            else
+            {
+                promise.set_value();
+            }
+        }
+    }
+};
+
+ModbusWriteBatcher::ModbusWriteBatcher(SsModbusMaster &master, const WriteBatchOptions &options)
+    : impl_(std::make_unique<Impl>(master, options)) {}
+
+ModbusWriteBatcher::~ModbusWriteBatcher() = default;
+
+std::future<void> ModbusWriteBatcher::write_single_register(uint8_t slave_address, uint16_t address,
+                                                            uint16_t value)
+{
+    return impl_->submit(slave_address, address, &value, 1);
+}
+
+std::future<void> ModbusWriteBatcher::write_multiple_registers(uint8_t slave_address, uint16_t address,
+                                                               const std::vector<uint16_t> &values)
+{
+    return impl_->submit(slave_address, address, values.data(), values.size());
+}
+
+void ModbusWriteBatcher::flush()
+{
+    impl_->send_pending();
+}
+
+size_t ModbusWriteBatcher::pending() const
+{
+    return impl_->pending();
+}
+
+} // namespace modbus
@@ -4,13 +4,34 @@
  */
 
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include <stdexcept>
 
+#include "inline_vector.h"
+
 namespace modbus
 {
 
+/// RTU帧最大长度：地址(1) + PDU(253) + CRC(2)
+constexpr size_t MAX_RTU_FRAME_SIZE = 256;
+
+/// PDU最大长度：功能码(1) + 数据(252)
+constexpr size_t MAX_PDU_SIZE = 253;
+
+/// 单次读取寄存器的最大数量(FC03/FC04)
+constexpr size_t MAX_READ_REGISTERS = 125;
+
+/// 单次写入寄存器的最大数量(FC16)
+constexpr size_t MAX_WRITE_REGISTERS = 123;
+
+/// 请求写入值，内联存放，不产生堆分配
+using RegisterValues = InlineVector<uint16_t, MAX_WRITE_REGISTERS>;
+
+/// 响应数据(功能码之后的字节)，内联存放，不产生堆分配
+using ResponseData = InlineVector<uint8_t, MAX_PDU_SIZE - 1>;
+
 /**
  * @brief Modbus功能码枚举
  */
@@ -63,7 +84,7 @@ struct ModbusRequest
     FunctionCode function_code;   ///< 功能码
     uint16_t start_address;       ///< 起始地址
     uint16_t register_count;      ///< 寄存器数量
-    std::vector<uint16_t> values; ///< 写入值(用于写操作)
+    RegisterValues values;        ///< 写入值(用于写操作)
 };
 
 /**
@@ -73,7 +94,7 @@ struct ModbusResponse
 {
     uint8_t slave_address;      ///< 从站地址
     FunctionCode function_code; ///< 功能码
-    std::vector<uint8_t> data;  ///< 响应数据
+    ResponseData data;          ///< 响应数据
     ModbusError error;          ///< 错误码
 };
 
@@ -87,4 +108,45 @@ enum class Parity
     EVEN  ///< 偶校验
 };
 
+/**
+ * @brief RS-485收发方向控制配置
+ * @details 由串口驱动在发送前后切换RTS(方向控制)，省去用户态切换或自动换向电路的等待时间
+ */
+struct Rs485Config
+{
+    bool enabled = false;                  ///< 是否启用驱动控制的RS-485模式，关闭时不改动串口当前设置
+    bool rts_on_send = true;               ///< 发送期间RTS为逻辑高(多数收发器DE高有效)
+    uint32_t delay_rts_before_send_us = 0; ///< 置RTS后到开始发送的延时(微秒，Linux下须为整毫秒)
+    uint32_t delay_rts_after_send_us = 0;  ///< 发送结束到释放RTS的延时(微秒，Linux下须为整毫秒)
+    bool rx_during_tx = false;             ///< 发送期间是否保持接收(回显)
+};
+
+/**
+ * @brief RTU串口配置
+ * @note Modbus规范要求无校验时使用2位停止位，但许多设备实际使用8N1，默认值保持8N1
+ */
+struct SerialConfig
+{
+    uint32_t baudrate = 9600;     ///< 波特率
+    uint8_t data_bits = 8;        ///< 数据位数，RTU规定为8
+    Parity parity = Parity::NONE; ///< 校验方式
+    uint8_t stop_bits = 1;        ///< 停止位数(1或2)
+    Rs485Config rs485;            ///< RS-485方向控制
+
+    /// 每个字符在线路上占用的位数：起始位 + 数据位 + 校验位 + 停止位
+    uint32_t bits_per_char() const
+    {
+        return 1u + data_bits + (parity == Parity::NONE ? 0u : 1u) + stop_bits;
+    }
+};
+
+/**
+ * @brief 串口接收延迟相关的实际设置
+ */
+struct SerialLatency
+{
+    bool low_latency = false;  ///< 驱动的低延迟模式(ASYNC_LOW_LATENCY)是否生效
+    int latency_timer_ms = -1; ///< USB串口芯片的接收缓冲延时(毫秒)，设备不提供时为-1
+};
+
 } // namespace modbus
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "device_adapter.h"
+#include "modbus_poll/modbus_write_batcher.h"
 
 namespace modbus
 {
@@ -21,6 +22,77 @@ void SsDeviceAdapter::changeTimeOut(int time_out)
     m_timeOut_ = std::chrono::milliseconds(time_out);
 }
 
+void SsDeviceAdapter::enableWriteBatching(ModbusWriteBatcher *batcher)
+{
+    if (!m_writeBatcher_ || batcher == m_writeBatcher_)
+    {
+        m_writeBatcher_ = batcher;
+        return;
+    }
+
+    // 先切换再报告原合并器中的写入错误，出错后也不再使用原合并器
+    drainWrites();
+    m_writeBatcher_ = batcher;
+    rethrowWriteError();
+}
+
+void SsDeviceAdapter::flushWrites()
+{
+    drainWrites();
+    rethrowWriteError();
+}
+
+void SsDeviceAdapter::drainWrites()
+{
+    if (m_writeBatcher_)
+    {
+        m_writeBatcher_->flush();
+    }
+    collectWrites(true);
+}
+
+void SsDeviceAdapter::rethrowWriteError()
+{
+    if (m_writeError_)
+    {
+        std::exception_ptr error = m_writeError_;
+        m_writeError_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void SsDeviceAdapter::queueWrite(std::future<void> write)
+{
+    collectWrites(false);
+    m_pendingWrites_.push_back(std::move(write));
+}
+
+void SsDeviceAdapter::collectWrites(bool wait)
+{
+    auto it = m_pendingWrites_.begin();
+    while (it != m_pendingWrites_.end())
+    {
+        if (!wait && it->wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        try
+        {
+            it->get();
+        }
+        catch (...)
+        {
+            if (!m_writeError_)
+            {
+                m_writeError_ = std::current_exception();
+            }
+        }
+        it = m_pendingWrites_.erase(it);
+    }
+}
+
 uint32_t SsDeviceAdapter::read_holding_registers(uint16_t address, uint8_t count)
 {
     if (count == 0 || count > 125)
@@ -28,6 +100,12 @@ uint32_t SsDeviceAdapter::read_holding_registers(uint16_t address, uint8_t count
         throw std::invalid_argument("Register count must be 1-125");
     }
 
+    // 先发送已合并的写入，保证读到的是写入后的值；写入错误留给flushWrites()报告
+    if (m_writeBatcher_)
+    {
+        drainWrites();
+    }
+
     ModbusRequest request{
         .slave_address = m_slaveAddr_,
         .function_code = FunctionCode::READ_HOLDING_REGISTERS,
@@ -62,6 +140,12 @@ uint32_t SsDeviceAdapter::read_holding_registers(uint16_t address, uint8_t count
 
 void SsDeviceAdapter::write_single_register(uint16_t address, uint16_t value)
 {
+    if (m_writeBatcher_)
+    {
+        queueWrite(m_writeBatcher_->write_single_register(m_slaveAddr_, address, value));
+        return;
+    }
+
     ModbusRequest request{
         .slave_address = m_slaveAddr_,
         .function_code = FunctionCode::WRITE_SINGLE_REGISTER,
@@ -84,6 +168,12 @@ void SsDeviceAdapter::write_multiple_registers(uint16_t address, const std::vect
         throw std::invalid_argument("Values count must be 1-123");
     }
 
+    if (m_writeBatcher_)
+    {
+        queueWrite(m_writeBatcher_->write_multiple_registers(m_slaveAddr_, address, values));
+        return;
+    }
+
     ModbusRequest request{
         .slave_address = m_slaveAddr_,
         .function_code = FunctionCode::WRITE_MULTIPLE_REGISTERS,
@@ -17,12 +17,17 @@ Version history
 #define SSDEVICE_ADAPTER_H
 
 #include <cstdint>
+#include <exception>
+#include <future>
+#include <vector>
 
 #include "modbus_master.h"
 
 namespace modbus
 {
 
+class ModbusWriteBatcher;
+
 class SsDeviceAdapter
 {
 public:
@@ -32,10 +37,41 @@ public:
 
     void changeTimeOut(int time_out);
 
+    /**
+     * @brief 启用写入合并
+     * @param batcher 写入合并器，为空时关闭；须使用与本适配器相同的主站
+     * @note 启用后写入只进入合并器队列而不等待结果，错误由flushWrites()报告；
+     *       读取前会先发送队列中的写入，保持先写后读的顺序，写入失败不影响该次读取。
+     *       合并的写入使用WriteBatchOptions::timeout，不使用本适配器的超时时间
+     * @throw ModbusException 更换或关闭时原合并器中的写入失败，此时已切换到新的合并器
+     */
+    void enableWriteBatching(ModbusWriteBatcher *batcher);
+
+    /**
+     * @brief 发送合并器中的写入并等待本适配器提交的写入全部完成
+     * @throw ModbusException 当某个写入失败时，抛出第一个失败的错误
+     */
+    void flushWrites();
+
 protected:
     SsModbusMaster &m_master_;
     uint8_t m_slaveAddr_;
     std::chrono::milliseconds m_timeOut_;
+    ModbusWriteBatcher *m_writeBatcher_ = nullptr;
+    std::vector<std::future<void>> m_pendingWrites_;
+    std::exception_ptr m_writeError_;
+
+    // 记录进入合并器的写入，并回收已完成的写入
+    void queueWrite(std::future<void> write);
+
+    // 取出已完成写入的结果，记录第一个错误
+    void collectWrites(bool wait);
+
+    // 发送合并器中的写入并等待其完成，错误留给flushWrites()报告
+    void drainWrites();
+
+    // 抛出并清除记录的第一个写入错误
+    void rethrowWriteError();
 
     /********* 基础方法封装 *********/
 
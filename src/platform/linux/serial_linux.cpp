@@ -7,74 +7,132 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <string.h>
+#include <linux/serial.h>
+#include <sys/ioctl.h>
 #include <unistd.h>
 
-LinuxSerialPort::LinuxSerialPort() : fd_(-1) {}
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+
+// 内核termios2结构，用于设置任意波特率(BOTHER)。<asm/termbits.h>与<termios.h>不能同时包含，
+// 这里按asm-generic布局自行声明，仅在采用该布局的架构上启用
+#if defined(TCGETS2) && (defined(__x86_64__) || defined(__i386__) || defined(__arm__) || \
+                         defined(__aarch64__) || defined(__riscv) || defined(__loongarch__))
+#define SERIAL_HAS_TERMIOS2 1
+struct termios2
+{
+    tcflag_t c_iflag;
+    tcflag_t c_oflag;
+    tcflag_t c_cflag;
+    tcflag_t c_lflag;
+    cc_t c_line;
+    cc_t c_cc[19];
+    speed_t c_ispeed;
+    speed_t c_ospeed;
+};
+#ifndef BOTHER
+#define BOTHER 0010000
+#endif
+#endif
+
+namespace
+{
+
+// 自定义波特率允许的最大偏差(%)，超出时UART间通信不可靠
+constexpr uint32_t MAX_BAUD_ERROR_PERCENT = 2;
+
+} // namespace
+
+LinuxSerialPort::LinuxSerialPort() : fd_(-1), lowLatency_(false), latencyTimer_(-1), failed_(false) {}
 
 LinuxSerialPort::~LinuxSerialPort()
 {
     close();
 }
 
-bool LinuxSerialPort::open(const std::string &port, uint32_t baudrate)
+bool LinuxSerialPort::open(const std::string &port, uint32_t baudrate, uint8_t dataBits, char parity,
+                           uint8_t stopBits)
 {
     if (isOpen())
     {
         close();
     }
 
+    // 校验字符格式
+    static const tcflag_t sizes[] = {CS5, CS6, CS7, CS8};
+    if (dataBits < 5 || dataBits > 8)
+    {
+        lastError_ = "Unsupported data bits: " + std::to_string(dataBits);
+        return false;
+    }
+    if (parity != 'N' && parity != 'E' && parity != 'O')
+    {
+        lastError_ = std::string("Unsupported parity: ") + parity;
+        return false;
+    }
+    if (stopBits != 1 && stopBits != 2)
+    {
+        lastError_ = "Unsupported stop bits: " + std::to_string(stopBits);
+        return false;
+    }
+
     // 打开串口设备 (非阻塞模式)
     fd_ = ::open(port.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
     if (fd_ < 0)
     {
+        lastError_ = "Failed to open " + port + ": " + strerror(errno);
         return false;
     }
 
     // 获取当前串口设置
     if (tcgetattr(fd_, &tty_) != 0)
     {
-        close();
+        fail("Failed to read serial port settings: " + std::string(strerror(errno)));
         return false;
     }
 
-    // 设置输入输出波特率
-    speed_t speed;
-    switch (baudrate)
-    {
-    case 9600:
-        speed = B9600;
-        break;
-    case 19200:
-        speed = B19200;
-        break;
-    case 38400:
-        speed = B38400;
-        break;
-    case 57600:
-        speed = B57600;
-        break;
-    case 115200:
-        speed = B115200;
-        break;
-    default:
-        speed = B9600;
-        break;
-    }
-    cfsetispeed(&tty_, speed);
-    cfsetospeed(&tty_, speed);
+    // 设置输入输出波特率，非标准波特率在其余设置生效后经termios2设置
+    speed_t speed = standardSpeed(baudrate);
+    if (speed == B0 && (baudrate == 0 || !customSpeedSupported()))
+    {
+        fail("Unsupported baud rate: " + std::to_string(baudrate));
+        return false;
+    }
+    if (speed != B0)
+    {
+        cfsetispeed(&tty_, speed);
+        cfsetospeed(&tty_, speed);
+    }
+
+    // 设置字符格式
+    tty_.c_cflag &= ~(PARENB | PARODD);       // 清除校验设置
+    if (parity != 'N')
+    {
+        tty_.c_cflag |= PARENB;               // 启用校验
+        if (parity == 'O')
+            tty_.c_cflag |= PARODD;           // 奇校验
+    }
+    if (stopBits == 2)
+        tty_.c_cflag |= CSTOPB;               // 2位停止位
+    else
+        tty_.c_cflag &= ~CSTOPB;              // 1位停止位
+    tty_.c_cflag &= ~CSIZE;                   // 清除数据位掩码
+    tty_.c_cflag |= sizes[dataBits - 5];      // 数据位
 
     // 设置常规配置
-    tty_.c_cflag &= ~PARENB;        // 无奇偶校验
-    tty_.c_cflag &= ~CSTOPB;        // 1位停止位
-    tty_.c_cflag &= ~CSIZE;         // 清除数据位掩码
-    tty_.c_cflag |= CS8;            // 8位数据位
     tty_.c_cflag &= ~CRTSCTS;       // 无硬件流控
     tty_.c_cflag |= CREAD | CLOCAL; // 启用接收，忽略控制线
 
     // 输入模式设置
     tty_.c_iflag &= ~(IXON | IXOFF | IXANY); // 关闭软件流控
     tty_.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL);
+    if (parity != 'N')
+        tty_.c_iflag |= INPCK;   // 检查接收校验，错误字节以0提交，由CRC校验剔除该帧
+    else
+        tty_.c_iflag &= ~INPCK;
 
     // 输出模式设置
     tty_.c_oflag &= ~OPOST; // 原始输出
@@ -90,11 +148,25 @@ bool LinuxSerialPort::open(const std::string &port, uint32_t baudrate)
     // 应用设置
     if (tcsetattr(fd_, TCSANOW, &tty_) != 0)
     {
-        close();
+        fail("Failed to configure serial port: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    // 驱动可能把不支持的标准速率改为其他值且tcsetattr仍返回成功，回读确认
+    if (speed == B0 ? !setCustomSpeed(baudrate) : !verifySpeed(baudrate, speed))
+    {
         return false;
     }
 
+    // 解析符号链接(如/dev/serial/by-id/...)得到内核设备名，记录其sysfs目录
+    char resolved[PATH_MAX];
+    std::string device = realpath(port.c_str(), resolved) ? resolved : port;
+    sysfsDir_ = "/sys/class/tty/" + device.substr(device.find_last_of('/') + 1) + "/device/";
+    readLatency();
+
     port_ = port;
+    lastError_.clear();
+    failed_ = false;
     return true;
 }
 
@@ -133,7 +205,359 @@ size_t LinuxSerialPort::read(uint8_t *buffer, size_t length)
     return static_cast<size_t>(bytesRead);
 }
 
+size_t LinuxSerialPort::read(uint8_t *buffer, size_t length, std::chrono::microseconds timeout)
+{
+    if (!isOpen())
+        return 0;
+
+    if (timeout.count() < 0)
+        timeout = std::chrono::microseconds(0);
+
+    // 按剩余时间精确等待可读事件，数据到达即唤醒
+    struct pollfd pfd;
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    struct timespec ts;
+    ts.tv_sec = timeout.count() / 1000000;
+    ts.tv_nsec = (timeout.count() % 1000000) * 1000;
+
+    int ret = ::ppoll(&pfd, 1, &ts, nullptr);
+    if (ret < 0)
+    {
+        if (errno != EINTR)
+        {
+            failed_ = true;
+            lastError_ = "Failed to wait for serial port: " + std::string(strerror(errno));
+        }
+        return 0;
+    }
+    if (ret == 0)
+    {
+        return 0;
+    }
+
+    // 设备被拔出或出错时只报告POLLHUP/POLLERR，不能当作超时，否则调用方会反复轮询
+    if (!(pfd.revents & POLLIN))
+    {
+        failed_ = true;
+        lastError_ = (pfd.revents & POLLHUP) ? "Serial port hung up" : "Serial port error";
+        return 0;
+    }
+
+    ssize_t bytesRead = ::read(fd_, buffer, length);
+    if (bytesRead > 0)
+    {
+        return static_cast<size_t>(bytesRead);
+    }
+
+    // 可读但读到0字节或读取出错，说明设备已断开
+    if (bytesRead == 0 || (errno != EAGAIN && errno != EINTR))
+    {
+        failed_ = true;
+        lastError_ = bytesRead == 0 ? "Serial port hung up"
+                                    : "Failed to read serial port: " + std::string(strerror(errno));
+    }
+    return 0;
+}
+
+bool LinuxSerialPort::failed() const
+{
+    return failed_;
+}
+
 bool LinuxSerialPort::isOpen() const
 {
     return fd_ >= 0;
+}
+
+const std::string &LinuxSerialPort::lastError() const
+{
+    return lastError_;
+}
+
+speed_t LinuxSerialPort::standardSpeed(uint32_t baudrate)
+{
+    static const struct
+    {
+        uint32_t baudrate;
+        speed_t speed;
+    } speeds[] = {
+        {50, B50},
+        {75, B75},
+        {110, B110},
+        {134, B134},
+        {150, B150},
+        {200, B200},
+        {300, B300},
+        {600, B600},
+        {1200, B1200},
+        {1800, B1800},
+        {2400, B2400},
+        {4800, B4800},
+        {9600, B9600},
+        {19200, B19200},
+        {38400, B38400},
+        {57600, B57600},
+        {115200, B115200},
+#ifdef B230400
+        {230400, B230400},
+#endif
+#ifdef B460800
+        {460800, B460800},
+#endif
+#ifdef B500000
+        {500000, B500000},
+#endif
+#ifdef B576000
+        {576000, B576000},
+#endif
+#ifdef B921600
+        {921600, B921600},
+#endif
+#ifdef B1000000
+        {1000000, B1000000},
+#endif
+#ifdef B1152000
+        {1152000, B1152000},
+#endif
+#ifdef B1500000
+        {1500000, B1500000},
+#endif
+#ifdef B2000000
+        {2000000, B2000000},
+#endif
+#ifdef B2500000
+        {2500000, B2500000},
+#endif
+#ifdef B3000000
+        {3000000, B3000000},
+#endif
+#ifdef B3500000
+        {3500000, B3500000},
+#endif
+#ifdef B4000000
+        {4000000, B4000000},
+#endif
+    };
+
+    for (const auto &entry : speeds)
+    {
+        if (entry.baudrate == baudrate)
+        {
+            return entry.speed;
+        }
+    }
+    return B0;
+}
+
+bool LinuxSerialPort::customSpeedSupported()
+{
+#ifdef SERIAL_HAS_TERMIOS2
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LinuxSerialPort::setCustomSpeed(uint32_t baudrate)
+{
+#ifdef SERIAL_HAS_TERMIOS2
+    struct termios2 tio;
+    if (ioctl(fd_, TCGETS2, &tio) != 0)
+    {
+        fail("Failed to read serial port settings: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    tio.c_cflag &= ~CBAUD;
+    tio.c_cflag |= BOTHER;
+    tio.c_ispeed = baudrate;
+    tio.c_ospeed = baudrate;
+    if (ioctl(fd_, TCSETS2, &tio) != 0)
+    {
+        fail("Unsupported baud rate: " + std::to_string(baudrate) + " (" + strerror(errno) + ")");
+        return false;
+    }
+
+    return verifySpeed(baudrate, B0);
+#else
+    fail("Unsupported baud rate: " + std::to_string(baudrate));
+    return false;
+#endif
+}
+
+/**
+ * @brief 回读实际生效的波特率
+ * @param baudrate 请求的波特率
+ * @param speed 对应的Bxxx常量，自定义波特率为B0
+ * @return 偏差在MAX_BAUD_ERROR_PERCENT以内返回true，否则关闭串口并返回false
+ */
+bool LinuxSerialPort::verifySpeed(uint32_t baudrate, speed_t speed)
+{
+#ifdef SERIAL_HAS_TERMIOS2
+    // 驱动会把波特率取整到时钟分频能达到的值，偏差过大时视为不支持
+    (void)speed;
+    struct termios2 tio;
+    if (ioctl(fd_, TCGETS2, &tio) != 0)
+    {
+        fail("Failed to read serial port settings: " + std::string(strerror(errno)));
+        return false;
+    }
+    uint32_t actual = tio.c_ospeed;
+    if (static_cast<uint64_t>(std::labs(static_cast<long>(actual) - static_cast<long>(baudrate))) * 100 >
+        static_cast<uint64_t>(baudrate) * MAX_BAUD_ERROR_PERCENT)
+    {
+        fail("Unsupported baud rate: " + std::to_string(baudrate) +
+             " (device runs at " + std::to_string(actual) + ")");
+        return false;
+    }
+    return true;
+#else
+    // 无termios2时只能比较Bxxx常量
+    struct termios tio;
+    if (tcgetattr(fd_, &tio) != 0)
+    {
+        fail("Failed to read serial port settings: " + std::string(strerror(errno)));
+        return false;
+    }
+    if (cfgetospeed(&tio) != speed)
+    {
+        fail("Unsupported baud rate: " + std::to_string(baudrate));
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool LinuxSerialPort::setRs485(bool enable, bool rtsOnSend, uint32_t delayBeforeSendUs,
+                               uint32_t delayAfterSendUs, bool rxDuringTx)
+{
+    if (!isOpen())
+    {
+        lastError_ = "Serial port is not open";
+        return false;
+    }
+
+    // 内核延时以毫秒为单位，不能静默放大或缩短方向切换的等待时间
+    if (enable && (delayBeforeSendUs % 1000 != 0 || delayAfterSendUs % 1000 != 0))
+    {
+        lastError_ = "RS-485 RTS delays must be whole milliseconds";
+        return false;
+    }
+
+    struct serial_rs485 rs485;
+    memset(&rs485, 0, sizeof(rs485));
+    if (enable)
+    {
+        rs485.flags |= SER_RS485_ENABLED;
+        rs485.flags |= rtsOnSend ? SER_RS485_RTS_ON_SEND : SER_RS485_RTS_AFTER_SEND;
+        if (rxDuringTx)
+        {
+            rs485.flags |= SER_RS485_RX_DURING_TX;
+        }
+        rs485.delay_rts_before_send = delayBeforeSendUs / 1000;
+        rs485.delay_rts_after_send = delayAfterSendUs / 1000;
+    }
+
+    if (ioctl(fd_, TIOCSRS485, &rs485) != 0)
+    {
+        lastError_ = errno == ENOTTY ? std::string("RS-485 mode not supported by driver")
+                                     : "TIOCSRS485 failed: " + std::string(strerror(errno));
+        return false;
+    }
+
+    // 驱动可能忽略不支持的标志或对延时限幅，读回确认方向控制和延时确实生效
+    struct serial_rs485 actual;
+    if (!enable || ioctl(fd_, TIOCGRS485, &actual) != 0)
+    {
+        return true;
+    }
+    if (!(actual.flags & SER_RS485_ENABLED))
+    {
+        lastError_ = "RS-485 mode not supported by driver";
+        return false;
+    }
+    if (actual.delay_rts_before_send != rs485.delay_rts_before_send ||
+        actual.delay_rts_after_send != rs485.delay_rts_after_send)
+    {
+        lastError_ = "RS-485 RTS delay not supported by driver (uses " +
+                     std::to_string(actual.delay_rts_before_send) + "/" +
+                     std::to_string(actual.delay_rts_after_send) + " ms)";
+        return false;
+    }
+    return true;
+}
+
+bool LinuxSerialPort::setLowLatency(uint32_t latencyTimerMs)
+{
+    if (!isOpen())
+    {
+        lastError_ = "Serial port is not open";
+        return false;
+    }
+
+    bool ok = true;
+    struct serial_struct serial;
+    if (ioctl(fd_, TIOCGSERIAL, &serial) == 0)
+    {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        if (ioctl(fd_, TIOCSSERIAL, &serial) != 0)
+        {
+            lastError_ = "TIOCSSERIAL failed: " + std::string(strerror(errno));
+            ok = false;
+        }
+    }
+    else
+    {
+        lastError_ = "Low latency mode not supported by driver";
+        ok = false;
+    }
+
+    // 部分驱动(如ftdi_sio)在设置ASYNC_LOW_LATENCY时已自行调整latency_timer，先读取再决定是否写入
+    readLatency();
+    if (latencyTimerMs > 0 && latencyTimer_ >= 0 && static_cast<uint32_t>(latencyTimer_) != latencyTimerMs)
+    {
+        std::ofstream timer(sysfsDir_ + "latency_timer");
+        timer << latencyTimerMs;
+        timer.close();
+        if (!timer)
+        {
+            lastError_ = "Failed to write " + sysfsDir_ + "latency_timer";
+            ok = false;
+        }
+        readLatency();
+    }
+    return ok;
+}
+
+bool LinuxSerialPort::lowLatency() const
+{
+    return lowLatency_;
+}
+
+int LinuxSerialPort::latencyTimer() const
+{
+    return latencyTimer_;
+}
+
+void LinuxSerialPort::readLatency()
+{
+    struct serial_struct serial;
+    lowLatency_ = ioctl(fd_, TIOCGSERIAL, &serial) == 0 && (serial.flags & ASYNC_LOW_LATENCY);
+
+    latencyTimer_ = -1;
+    std::ifstream timer(sysfsDir_ + "latency_timer");
+    int value;
+    if (timer >> value)
+    {
+        latencyTimer_ = value;
+    }
+}
+
+void LinuxSerialPort::fail(const std::string &reason)
+{
+    lastError_ = reason;
+    close();
 }
\ No newline at end of file
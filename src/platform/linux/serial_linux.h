@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <termios.h>
 #include <string>
@@ -19,10 +20,15 @@ public:
     /**
      * @brief 打开串口
      * @param port 串口设备路径，如"/dev/ttyUSB0"
-     * @param baudrate 波特率
-     * @return 成功返回true，失败返回false
+     * @param baudrate 波特率，支持全部标准Bxxx速率，其余速率经termios2(BOTHER)设置
+     * @param dataBits 数据位数(5-8)
+     * @param parity 校验方式：'N'无校验，'E'偶校验，'O'奇校验
+     * @param stopBits 停止位数(1或2)
+     * @return 成功返回true，失败返回false，原因见 lastError()
+     * @note 驱动无法设置所请求的波特率(或实际速率偏差超过2%)时打开失败，不会退回其他速率
      */
-    bool open(const std::string &port, uint32_t baudrate);
+    bool open(const std::string &port, uint32_t baudrate, uint8_t dataBits = 8, char parity = 'N',
+              uint8_t stopBits = 1);
 
     /**
      * @brief 关闭串口
@@ -45,14 +51,90 @@ public:
      */
     size_t read(uint8_t *buffer, size_t length);
 
+    /**
+     * @brief 等待数据到达后读取
+     * @param buffer 接收缓冲区
+     * @param length 期望读取的最大长度
+     * @param timeout 等待数据可读的最长时间
+     * @return 实际读取的字节数，超时或出错返回0，出错时 failed() 为true
+     * @note 有数据可读即立即返回，不会等满length字节
+     */
+    size_t read(uint8_t *buffer, size_t length, std::chrono::microseconds timeout);
+
+    /**
+     * @brief 串口是否已出错(如USB串口被拔出)，出错后读取不再有数据，需重新打开
+     */
+    bool failed() const;
+
     /**
      * @brief 检查串口是否打开
      * @return 打开返回true，否则返回false
      */
     bool isOpen() const;
 
+    /**
+     * @brief 配置RS-485收发方向控制
+     * @param enable 是否启用驱动控制的RS-485模式
+     * @param rtsOnSend 发送期间RTS为逻辑高
+     * @param delayBeforeSendUs 置RTS后到开始发送的延时(微秒)
+     * @param delayAfterSendUs 发送结束到释放RTS的延时(微秒)
+     * @param rxDuringTx 发送期间是否保持接收
+     * @return 成功返回true，失败返回false，原因见 lastError()
+     * @note 经TIOCSRS485交由内核驱动切换RTS；内核延时以毫秒为单位，延时不是整毫秒，
+     *       或驱动实际采用的延时与请求值不同(如被限幅)时返回失败
+     */
+    bool setRs485(bool enable, bool rtsOnSend, uint32_t delayBeforeSendUs, uint32_t delayAfterSendUs,
+                  bool rxDuringTx);
+
+    /**
+     * @brief 启用低延迟接收
+     * @param latencyTimerMs USB串口芯片(FTDI等)的接收缓冲延时(毫秒)，设备在sysfs提供latency_timer时写入，0表示不修改
+     * @return 全部设置成功返回true，否则返回false，原因见 lastError()
+     * @note 经TIOCSSERIAL设置ASYNC_LOW_LATENCY，驱动收到数据后立即提交而不是等待缓冲定时器；
+     *       写latency_timer通常需要root权限。无论成功与否，lowLatency()/latencyTimer()都反映实际生效的值
+     */
+    bool setLowLatency(uint32_t latencyTimerMs = 1);
+
+    /**
+     * @brief ASYNC_LOW_LATENCY是否生效(打开时及设置后读取)
+     */
+    bool lowLatency() const;
+
+    /**
+     * @brief USB串口芯片的接收缓冲延时(毫秒)，设备不提供时为-1
+     */
+    int latencyTimer() const;
+
+    /**
+     * @brief 获取最近一次操作失败的原因
+     */
+    const std::string &lastError() const;
+
 private:
-    int fd_;             ///< 文件描述符
-    struct termios tty_; ///< 终端设置
-    std::string port_;   ///< 串口设备路径
+    int fd_;                ///< 文件描述符
+    struct termios tty_;    ///< 终端设置
+    std::string port_;      ///< 串口设备路径
+    std::string lastError_; ///< 最近一次操作失败的原因
+    std::string sysfsDir_;  ///< 设备在sysfs中的目录
+    bool lowLatency_;       ///< ASYNC_LOW_LATENCY是否生效
+    int latencyTimer_;      ///< latency_timer(毫秒)，-1表示不提供
+    bool failed_;           ///< 设备是否已出错
+
+    // 标准波特率对应的Bxxx常量，非标准速率返回B0
+    static speed_t standardSpeed(uint32_t baudrate);
+
+    // 是否支持经termios2设置任意波特率
+    static bool customSpeedSupported();
+
+    // 经termios2设置任意波特率
+    bool setCustomSpeed(uint32_t baudrate);
+
+    // 回读实际生效的波特率，与请求值偏差过大时失败
+    bool verifySpeed(uint32_t baudrate, speed_t speed);
+
+    // 读取实际生效的低延迟设置
+    void readLatency();
+
+    // 记录失败原因并关闭串口
+    void fail(const std::string &reason);
 };
\ No newline at end of file
@@ -14,13 +14,31 @@ WinSerialPort::~WinSerialPort()
     close();
 }
 
-bool WinSerialPort::open(const std::string &port, uint32_t baudrate)
+bool WinSerialPort::open(const std::string &port, uint32_t baudrate, uint8_t dataBits, char parity,
+                         uint8_t stopBits)
 {
     if (isOpen())
     {
         close();
     }
 
+    // 校验字符格式
+    if (dataBits < 5 || dataBits > 8)
+    {
+        lastError_ = "Unsupported data bits: " + std::to_string(dataBits);
+        return false;
+    }
+    if (parity != 'N' && parity != 'E' && parity != 'O')
+    {
+        lastError_ = std::string("Unsupported parity: ") + parity;
+        return false;
+    }
+    if (stopBits != 1 && stopBits != 2)
+    {
+        lastError_ = "Unsupported stop bits: " + std::to_string(stopBits);
+        return false;
+    }
+
     // 打开串口 (同步模式)
     hSerial_ = CreateFileA(
         ("\\\\.\\" + port).c_str(),
@@ -33,26 +51,30 @@ bool WinSerialPort::open(const std::string &port, uint32_t baudrate)
 
     if (hSerial_ == INVALID_HANDLE_VALUE)
     {
+        fail("Failed to open " + port);
         return false;
     }
 
     // 获取当前串口参数
     if (!GetCommState(hSerial_, &dcbSerialParams_))
     {
-        close();
+        fail("Failed to read serial port settings");
         return false;
     }
 
     // 配置串口参数
     dcbSerialParams_.BaudRate = baudrate;
-    dcbSerialParams_.ByteSize = 8;
-    dcbSerialParams_.StopBits = ONESTOPBIT;
-    dcbSerialParams_.Parity = NOPARITY;
+    dcbSerialParams_.ByteSize = dataBits;
+    dcbSerialParams_.StopBits = stopBits == 2 ? TWOSTOPBITS : ONESTOPBIT;
+    dcbSerialParams_.Parity = parity == 'E' ? EVENPARITY : (parity == 'O' ? ODDPARITY : NOPARITY);
+    dcbSerialParams_.fParity = parity != 'N';
     dcbSerialParams_.fDtrControl = DTR_CONTROL_ENABLE;
 
+    // 驱动不支持的波特率在此失败，不会退回其他速率
     if (!SetCommState(hSerial_, &dcbSerialParams_))
     {
-        close();
+        fail("Unsupported serial settings (" + std::to_string(baudrate) + " " + std::to_string(dataBits) +
+             parity + std::to_string(stopBits) + ")");
         return false;
     }
 
@@ -65,11 +87,13 @@ bool WinSerialPort::open(const std::string &port, uint32_t baudrate)
 
     if (!SetCommTimeouts(hSerial_, &timeouts_))
     {
-        close();
+        fail("Failed to set serial port timeouts");
         return false;
     }
 
     port_ = port;
+    lastError_.clear();
+    failed_ = false;
     return true;
 }
 
@@ -100,15 +124,116 @@ size_t WinSerialPort::read(uint8_t *buffer, size_t length)
     if (!isOpen())
         return 0;
 
+    // 恢复默认超时设置
+    if (waitTimeoutMs_ != 0)
+    {
+        if (!SetCommTimeouts(hSerial_, &timeouts_))
+        {
+            return 0;
+        }
+        waitTimeoutMs_ = 0;
+    }
+
+    DWORD bytesRead;
+    if (!ReadFile(hSerial_, buffer, static_cast<DWORD>(length), &bytesRead, NULL))
+    {
+        return 0;
+    }
+    return static_cast<size_t>(bytesRead);
+}
+
+size_t WinSerialPort::read(uint8_t *buffer, size_t length, std::chrono::microseconds timeout)
+{
+    if (!isOpen())
+        return 0;
+
+    // ReadIntervalTimeout与ReadTotalTimeoutMultiplier均为MAXDWORD时，
+    // ReadFile在有数据到达时立即返回，否则最多等待ReadTotalTimeoutConstant
+    DWORD wait_ms = static_cast<DWORD>((timeout.count() + 999) / 1000);
+    if (wait_ms == 0)
+        wait_ms = 1;
+    if (wait_ms != waitTimeoutMs_)
+    {
+        COMMTIMEOUTS timeouts = timeouts_;
+        timeouts.ReadIntervalTimeout = MAXDWORD;
+        timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+        timeouts.ReadTotalTimeoutConstant = wait_ms;
+        if (!SetCommTimeouts(hSerial_, &timeouts))
+        {
+            return 0;
+        }
+        waitTimeoutMs_ = wait_ms;
+    }
+
     DWORD bytesRead;
     if (!ReadFile(hSerial_, buffer, static_cast<DWORD>(length), &bytesRead, NULL))
     {
+        // 设备被拔出等错误不能当作超时，否则调用方会反复轮询
+        failed_ = true;
+        lastError_ = "Failed to read serial port (error " + std::to_string(GetLastError()) + ")";
         return 0;
     }
     return static_cast<size_t>(bytesRead);
 }
 
+bool WinSerialPort::failed() const
+{
+    return failed_;
+}
+
 bool WinSerialPort::isOpen() const
 {
     return hSerial_ != INVALID_HANDLE_VALUE;
-}
\ No newline at end of file
+}
+
+bool WinSerialPort::setRs485(bool enable, bool rtsOnSend, uint32_t delayBeforeSendUs,
+                             uint32_t delayAfterSendUs, bool rxDuringTx)
+{
+    if (!isOpen())
+    {
+        lastError_ = "Serial port is not open";
+        return false;
+    }
+
+    // RTS_CONTROL_TOGGLE只支持发送期间RTS为高，且不支持延时和回显控制
+    if (enable && (!rtsOnSend || delayBeforeSendUs != 0 || delayAfterSendUs != 0 || rxDuringTx))
+    {
+        lastError_ = "RS-485 option not supported on Windows";
+        return false;
+    }
+
+    dcbSerialParams_.fRtsControl = enable ? RTS_CONTROL_TOGGLE : RTS_CONTROL_ENABLE;
+    if (!SetCommState(hSerial_, &dcbSerialParams_))
+    {
+        lastError_ = "Failed to set RTS control (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    return true;
+}
+
+bool WinSerialPort::setLowLatency(uint32_t)
+{
+    lastError_ = "Low latency mode not supported on Windows";
+    return false;
+}
+
+bool WinSerialPort::lowLatency() const
+{
+    return false;
+}
+
+int WinSerialPort::latencyTimer() const
+{
+    return -1;
+}
+
+const std::string &WinSerialPort::lastError() const
+{
+    return lastError_;
+}
+
+void WinSerialPort::fail(const std::string &reason)
+{
+    lastError_ = reason + " (error " + std::to_string(GetLastError()) + ")";
+    close();
+}
@@ -6,6 +6,7 @@
 #pragma once
 #include <windows.h>
 
+#include <chrono>
 #include <cstdint>
 #include <string>
 
@@ -19,9 +20,13 @@ public:
      * @brief 打开串口
      * @param port 串口名称 (如"COM1")
      * @param baudrate 波特率
-     * @return 成功返回true，失败返回false
+     * @param dataBits 数据位数(5-8)
+     * @param parity 校验方式：'N'无校验，'E'偶校验，'O'奇校验
+     * @param stopBits 停止位数(1或2)
+     * @return 成功返回true，失败返回false，原因见 lastError()
      */
-    bool open(const std::string &port, uint32_t baudrate);
+    bool open(const std::string &port, uint32_t baudrate, uint8_t dataBits = 8, char parity = 'N',
+              uint8_t stopBits = 1);
 
     /**
      * @brief 关闭串口
@@ -44,15 +49,70 @@ public:
      */
     size_t read(uint8_t *buffer, size_t length);
 
+    /**
+     * @brief 等待数据到达后读取
+     * @param buffer 接收缓冲区
+     * @param length 期望读取的最大长度
+     * @param timeout 等待数据可读的最长时间
+     * @return 实际读取的字节数，超时或出错返回0，出错时 failed() 为true
+     * @note 有数据可读即立即返回，不会等满length字节
+     */
+    size_t read(uint8_t *buffer, size_t length, std::chrono::microseconds timeout);
+
+    /**
+     * @brief 串口是否已出错(如USB串口被拔出)，出错后读取不再有数据，需重新打开
+     */
+    bool failed() const;
+
     /**
      * @brief 检查串口是否打开
      * @return 打开返回true，否则返回false
      */
     bool isOpen() const;
 
+    /**
+     * @brief 配置RS-485收发方向控制
+     * @param enable 是否启用驱动控制的RS-485模式
+     * @param rtsOnSend 发送期间RTS为逻辑高
+     * @param delayBeforeSendUs 置RTS后到开始发送的延时(微秒)
+     * @param delayAfterSendUs 发送结束到释放RTS的延时(微秒)
+     * @param rxDuringTx 发送期间是否保持接收
+     * @return 成功返回true，失败返回false，原因见 lastError()
+     * @note 使用RTS_CONTROL_TOGGLE由驱动在发送期间置RTS；Windows不支持延时和RTS极性设置，非默认值时返回失败
+     */
+    bool setRs485(bool enable, bool rtsOnSend, uint32_t delayBeforeSendUs, uint32_t delayAfterSendUs,
+                  bool rxDuringTx);
+
+    /**
+     * @brief 启用低延迟接收
+     * @note Windows下USB串口的缓冲延时由驱动属性(注册表)设置，此处不支持，总是返回false
+     */
+    bool setLowLatency(uint32_t latencyTimerMs = 1);
+
+    /**
+     * @brief 低延迟模式是否生效，Windows下总是false
+     */
+    bool lowLatency() const;
+
+    /**
+     * @brief USB串口芯片的接收缓冲延时(毫秒)，Windows下无法读取，总是-1
+     */
+    int latencyTimer() const;
+
+    /**
+     * @brief 获取最近一次操作失败的原因
+     */
+    const std::string &lastError() const;
+
 private:
     HANDLE hSerial_;              ///< 串口句柄
     DCB dcbSerialParams_ = {0};   ///< 串口参数
     COMMTIMEOUTS timeouts_ = {0}; ///< 超时设置
+    DWORD waitTimeoutMs_ = 0;     ///< 当前生效的等待超时(毫秒)，0表示默认超时设置
     std::string port_;            ///< 串口名称
+    std::string lastError_;       ///< 最近一次操作失败的原因
+    bool failed_ = false;         ///< 设备是否已出错
+
+    // 记录失败原因(附带GetLastError)并关闭串口
+    void fail(const std::string &reason);
 };
\ No newline at end of file